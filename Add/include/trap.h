@@ -3,6 +3,7 @@
 
 #include <base.h>
 #include <tool.h>
+#include <perf.h>
 
 __attribute__((noinline))
 void check(int cond) {
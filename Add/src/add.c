@@ -64,6 +64,7 @@ int main() {
 	};
 	volatile int c[512] ;
 	int test = 20;
+	ROI_BEGIN();
 	for(int t=0;t<test;t++)
 	{
 		for(int i=0;i<512;i++)
@@ -71,6 +72,7 @@ int main() {
 			c[i] = a[i] + b[i];
 		}
 	}
+	ROI_END();
 	return 0;
 }
 
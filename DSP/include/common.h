@@ -3,5 +3,6 @@
 
 #include <base.h>
 #include <tool.h>
+#include <perf.h>
 
 #endif
\ No newline at end of file
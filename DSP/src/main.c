@@ -1,11 +1,14 @@
 #include "fir.h"
+#include <perf.h>
 
 #define INPUT_SIZE 320
 #define NUM_TAPS 29
 #define BLOCK_SIZE 32
 #define BLOCK_NUM (INPUT_SIZE / BLOCK_SIZE)
+#define MAX_HARTS 8
 
-const q15_t firCoeffs32[NUM_TAPS] = {
+// coefficients and per-hart state are the hot data of the filter loop
+q15_t firCoeffs32[NUM_TAPS] __dtcm = {
     1, 2, 3, 1, 2, 3, 2, 2,
     4, 2, 3, 1, 4, 4, 0, 2,
     0, 2, 3, 4, 2, 1, 3, 3,
@@ -13,21 +16,55 @@ const q15_t firCoeffs32[NUM_TAPS] = {
 };
 
 static q15_t testOutput[INPUT_SIZE];
+static q15_t refOutput[INPUT_SIZE];
+static q15_t firState[MAX_HARTS][NUM_TAPS + BLOCK_SIZE - 1] __dtcm_bss;
 
 extern q15_t testInput_f32_1kHz_15kHz[INPUT_SIZE];
-extern 
 
-int main() {
+void fir_stream(uint32_t samples);
+
+/* Filter blocks [begin, end) on the calling hart. The state is primed with
+ * the NUM_TAPS - 1 samples before the first block, so any split of the
+ * blocks across harts gives the same output as one sequential pass. */
+static void fir_blocks(int begin, int end, void *out) {
     riscv_fir_instance_q15 S;
-    // riscv_status status;
+    q15_t *state = firState[hart_id()];
     q15_t *input = testInput_f32_1kHz_15kHz;
-    q15_t *output = testOutput;
-    
+    q15_t *output = out;
 
-    riscv_fir_init_q15(&S, NUM_TAPS, firCoeffs32, NULL, BLOCK_SIZE);
-    for (int i = 0; i < BLOCK_NUM; i++) {
-        riscv_fir_q15(&S, input, output, BLOCK_SIZE);
+    riscv_fir_init_q15(&S, NUM_TAPS, firCoeffs32, state, BLOCK_SIZE);
+    for (int k = 1; k < NUM_TAPS && begin * BLOCK_SIZE - k >= 0; k++) {
+        state[NUM_TAPS - 1 - k] = input[begin * BLOCK_SIZE - k];
     }
-    return 0;
+    for (int i = begin; i < end; i++) {
+        riscv_fir_q15(&S, input + i * BLOCK_SIZE, output + i * BLOCK_SIZE, BLOCK_SIZE);
+    }
+}
+
+int main() {
+    panic_on(num_harts() > MAX_HARTS, "raise MAX_HARTS");
+
+    uint64_t t_serial = read_cycle64();
+    ROI_BEGIN();
+    fir_blocks(0, BLOCK_NUM, refOutput);
+    ROI_END();
+    t_serial = read_cycle64() - t_serial;
 
-}
\ No newline at end of file
+    // speedup of the block loop as harts are added
+    for (int n = 2; n <= num_harts(); n++) {
+        parallel_set_harts(n);
+        memset(testOutput, 0, sizeof(testOutput));
+        uint64_t t0 = read_cycle64();
+        parallel_for(0, BLOCK_NUM, 1, fir_blocks, testOutput);
+        uint64_t t = read_cycle64() - t0;
+        panic_on(memcmp(testOutput, refOutput, sizeof(refOutput)) != 0, "parallel fir mismatch");
+        printf("fir %d harts: %llu cycles, speedup ", n, t);
+        print_ratio(t_serial, t, 2);
+        putch('\n');
+    }
+
+#ifdef FIR_STREAM_SAMPLES
+    fir_stream(FIR_STREAM_SAMPLES);
+#endif
+    return 0;
+}
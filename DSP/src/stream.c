@@ -0,0 +1,63 @@
+#include "fir.h"
+#include <perf.h>
+
+/* Streaming FIR over a raw little-endian q15 sample file on the ramdisk.
+ * The input occupies [0, 2 * samples) and the filtered output is written
+ * right after it. Input blocks are double-buffered with disk_stream, so the
+ * next block is read while the current one is filtered. streamGen.py writes
+ * a matching disk image and prints the CRC32 of the expected output. */
+
+#define NUM_TAPS 29
+#define STREAM_BLOCK 1024
+
+extern q15_t firCoeffs32[NUM_TAPS];
+
+static q15_t inBuf[2][STREAM_BLOCK];
+static q15_t outBuf[STREAM_BLOCK];
+static q15_t streamState[NUM_TAPS + STREAM_BLOCK - 1] __dtcm_bss;
+
+// CRC-32 (IEEE 802.3, reflected), the same as zlib.crc32
+static uint32_t crc32(uint32_t crc, const void *buf, uint32_t len) {
+    static uint32_t table[256];
+    if (table[1] == 0) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t rem = i;
+            for (int j = 0; j < 8; j++)
+                rem = (rem >> 1) ^ (rem & 1 ? 0xedb88320 : 0);
+            table[i] = rem;
+        }
+    }
+    const uint8_t *p = buf;
+    crc = ~crc;
+    while (len--)
+        crc = (crc >> 8) ^ table[(crc ^ *p++) & 0xff];
+    return ~crc;
+}
+
+void fir_stream(uint32_t samples) {
+    riscv_fir_instance_q15 S;
+    disk_stream_t in;
+    uint32_t out = samples * sizeof(q15_t), crc = 0, len;
+    uint64_t filter = 0;
+
+    riscv_fir_init_q15(&S, NUM_TAPS, firCoeffs32, streamState, STREAM_BLOCK);
+    uint64_t t0 = read_cycle64();
+    disk_stream_open(&in, inBuf[0], inBuf[1], sizeof(inBuf[0]), 0, samples * sizeof(q15_t));
+    for (q15_t *src; (src = disk_stream_next(&in, &len)) != NULL; ) {
+        uint32_t n = len / sizeof(q15_t);
+        uint64_t t = read_cycle64();
+        riscv_fir_q15(&S, src, outBuf, n);
+        filter += read_cycle64() - t;
+        crc = crc32(crc, outBuf, len);
+        ramdisk_write(outBuf, out, len);
+        out += len;
+    }
+    uint64_t total = read_cycle64() - t0;
+
+    printf("fir stream: %d samples, %llu cycles (filter %llu), samples/cycle ",
+           samples, total, filter);
+    print_ratio(samples, total, 4);
+    printf(", filter only ");
+    print_ratio(samples, filter, 4);
+    printf("\nfir stream crc32: %08x\n", crc);
+}
@@ -0,0 +1,46 @@
+# 生成 FIR 流式测试用的 ramdisk 镜像，并打印期望输出的 CRC32
+# 用法: python3 streamGen.py <采样数> <镜像文件>
+# 镜像前半部分是 q15 小端输入，后半部分留给程序写回的输出
+import math
+import random
+import re
+import struct
+import sys
+import zlib
+
+samples = int(sys.argv[1]) if len(sys.argv) > 1 else 1 << 20
+image = sys.argv[2] if len(sys.argv) > 2 else "fir-stream.img"
+
+# 系数与 src/main.c 中的 firCoeffs32 保持一致
+src = open(__file__.replace("streamGen.py", "src/main.c")).read()
+body = re.search(r"firCoeffs32\[NUM_TAPS\][^{]*\{([^}]*)\}", src).group(1)
+coeffs = [int(c) for c in body.replace("\n", "").split(",") if c.strip()]
+
+# 1kHz + 15kHz 正弦叠加少量噪声, 采样率 48kHz
+random.seed(0)
+x = []
+for n in range(samples):
+    v = 0.4 * math.sin(2 * math.pi * 1000 * n / 48000) \
+      + 0.4 * math.sin(2 * math.pi * 15000 * n / 48000) \
+      + random.uniform(-0.05, 0.05)
+    x.append(max(-32768, min(32767, int(v * 32768))))
+
+# 与 riscv_fir_q15 相同: 两两展开的循环只用到前 numTaps & ~1 个系数,
+# y[n] = sum(c[j] * x[n - (numTaps - 1) + j]), 结果 >> 15 后饱和到 16 位
+taps = len(coeffs) & ~1
+hist = len(coeffs) - 1
+padded = [0] * hist + x
+y = bytearray()
+for n in range(samples):
+    acc = 0
+    window = padded[n: n + taps]
+    for c, s in zip(coeffs, window):
+        acc += c * s
+    y += struct.pack("<h", max(-32768, min(32767, acc >> 15)))
+
+with open(image, "wb") as f:
+    f.write(struct.pack("<%dh" % samples, *x))
+    f.write(bytes(len(y)))
+
+print("samples: %d, image: %s" % (samples, image))
+print("fir stream crc32: %08x" % zlib.crc32(bytes(y)))
@@ -13,6 +13,22 @@
   ({ reg##_T __io_param = (reg##_T) { __VA_ARGS__ }; \
     ioe_write(reg, &__io_param); })
 
+// placement in tightly coupled memory (see linker.ld); code and initialized
+// data are copied there by _start, __dtcm_bss data is zeroed. Without a
+// TCM base (make ITCM_BASE=/DTCM_BASE=) objects stay in RAM as usual.
+#ifdef ITCM_BASE
+#define __itcm      __attribute__((section(".itcm"), noinline))
+#else
+#define __itcm      __attribute__((noinline))
+#endif
+#ifdef DTCM_BASE
+#define __dtcm      __attribute__((section(".dtcm")))
+#define __dtcm_bss  __attribute__((section(".dtcm_bss")))
+#else
+#define __dtcm
+#define __dtcm_bss
+#endif
+
 #define RANGE(st, ed)       (Area) { .start = (void *)(st), .end = (void *)(ed) }
 
 #endif
@@ -32,11 +32,15 @@ typedef struct {
 extern   Area        heap;
 void halt(int code);
 void putch(char ch);
+void flush();
 bool ioe_init();
 void ioe_read(int reg, void *buf);
 void ioe_write(int reg, void *buf);
 void yield();
 bool cte_init(Context *(*handler)(Event, Context *));
+int  hart_id();
+int  num_harts();
+void harts_release(void (*entry)(int hartid));
 
 #include <base-macro.h>
 #endif
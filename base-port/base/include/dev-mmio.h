@@ -12,6 +12,13 @@
 #define FFB_ADDR        (MMIO_BASE + 0x2000000)
 // disk ctl
 #define DISK_CTL_ADDR   (MMIO_BASE + 0x0000300)
+// core-local interruptor: machine timer
+#ifndef CLINT_ADDR
+#define CLINT_ADDR      0x02000000
+#endif
+#define CLINT_MSIP      (CLINT_ADDR + 0x0000)
+#define CLINT_MTIMECMP  (CLINT_ADDR + 0x4000)
+#define CLINT_MTIME     (CLINT_ADDR + 0xbff8)
 
 static inline uint8_t  inb(uintptr_t addr) { return *(volatile uint8_t  *)addr; }
 static inline uint16_t inw(uintptr_t addr) { return *(volatile uint16_t *)addr; }
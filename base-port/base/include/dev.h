@@ -62,9 +62,41 @@ struct gpu_canvas {
   };
 } __attribute__((packed));
 
-#endif
-
-
 // DISK
+
 uint64_t ramdisk_read(void *buf, uint64_t offset, uint64_t len);
-uint64_t ramdisk_write(const void *buf, uint64_t offset, uint64_t len);
\ No newline at end of file
+uint64_t ramdisk_write(const void *buf, uint64_t offset, uint64_t len);
+
+// Asynchronous transfers. A submitted request is owned by the driver, and
+// its buffer must not be touched, until disk_poll() returns true for it.
+enum { DISK_READ = 1, DISK_WRITE = 2 };
+enum { DISK_REQ_IDLE = 0, DISK_REQ_QUEUED, DISK_REQ_BUSY, DISK_REQ_DONE };
+
+typedef struct {
+  void *buf;
+  uint32_t offset, len;
+  uint8_t cmd;
+  volatile uint8_t state;
+} disk_req_t;
+
+void disk_submit(disk_req_t *req);
+bool disk_poll  (disk_req_t *req);
+void disk_wait  (disk_req_t *req);
+
+// Double-buffered sequential read of [offset, offset + len) in `block'-byte
+// pieces: the next block is read into one buffer while the caller works on
+// the other.
+typedef struct {
+  uint8_t *buf[2];
+  uint32_t block, next, end;
+  int cur;
+  disk_req_t req[2];
+} disk_stream_t;
+
+void  disk_stream_open(disk_stream_t *s, void *buf0, void *buf1, uint32_t block,
+                       uint32_t offset, uint32_t len);
+/* returns the next block (valid until the following call) and sets *len,
+ * or returns NULL at the end of the range */
+void *disk_stream_next(disk_stream_t *s, uint32_t *len);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef PERF_H__
+#define PERF_H__
+
+#include <stdint.h>
+
+/* Hardware performance counters (Zicsr/Zicntr/Zihpm).
+ *
+ * On RV32 each 64-bit counter is split into a low and a high CSR. The
+ * high half is read before and after the low half and the read retried
+ * if it changed, so a carry out of the low word between the two reads
+ * cannot produce a value that is off by 2^32. */
+
+#define __csr_read(csr) \
+  ({ uint32_t __v; asm volatile("csrr %0, " #csr : "=r"(__v)); __v; })
+
+#if __riscv_xlen == 32
+#define __csr_read64(csr) \
+  ({ uint32_t __hi, __lo, __hi2; \
+    do { \
+      __hi  = __csr_read(csr##h); \
+      __lo  = __csr_read(csr); \
+      __hi2 = __csr_read(csr##h); \
+    } while (__hi != __hi2); \
+    ((uint64_t)__hi << 32) | __lo; })
+#else
+#define __csr_read64(csr) \
+  ({ uint64_t __v; asm volatile("csrr %0, " #csr : "=r"(__v)); __v; })
+#endif
+
+static inline uint64_t read_cycle64()   { return __csr_read64(cycle); }
+static inline uint64_t read_instret64() { return __csr_read64(instret); }
+
+/* low words only, for intervals known to be shorter than 2^32 cycles */
+static inline uint32_t read_cycle()     { return __csr_read(cycle); }
+static inline uint32_t read_instret()   { return __csr_read(instret); }
+
+/* mhpmcounter3..31; n must be an integer literal since it names the CSR */
+#define read_hpm(n) __csr_read64(mhpmcounter##n)
+
+typedef struct {
+  uint64_t cycles, instret;
+} perf_snapshot;
+
+static inline perf_snapshot perf_read() {
+  perf_snapshot s;
+  s.cycles  = read_cycle64();
+  s.instret = read_instret64();
+  return s;
+}
+
+static inline perf_snapshot perf_delta(perf_snapshot begin, perf_snapshot end) {
+  return (perf_snapshot) {
+    .cycles  = end.cycles  - begin.cycles,
+    .instret = end.instret - begin.instret,
+  };
+}
+
+/* Region of interest. Cycles and instructions between ROI_BEGIN() and
+ * ROI_END() are accumulated over every pair executed, so setup and result
+ * checking stay out of the count. If any region was closed, halt() prints
+ * "ROI cycles: C, instrs: I, IPC: x" and "Startup cycles: S" (from _start
+ * to main, see start.S) before the simulator's own totals. */
+extern perf_snapshot __roi_begin, __roi_total;
+extern int __roi_count;
+extern uint32_t __startup_cycles;
+
+#define ROI_BEGIN() ({ __PROF_BEGIN(); __roi_begin = perf_read(); })
+#define ROI_END() \
+  ({ perf_snapshot __d = perf_delta(__roi_begin, perf_read()); \
+    __roi_total.cycles  += __d.cycles; \
+    __roi_total.instret += __d.instret; \
+    __roi_count++; \
+    __PROF_END(); })
+
+/* Sampling profiler (base/src/prof.c). The machine timer interrupt records
+ * mepc every `ticks' mtime ticks; halt() prints the pc histogram as "PROF"
+ * lines that script/prof.py symbolizes. Building with PROF_INTERVAL=<ticks>
+ * (make prof PROF=<ticks>) samples every region of interest. */
+void prof_start(uint32_t ticks);
+void prof_stop();
+
+#ifdef PROF_INTERVAL
+#define __PROF_BEGIN() prof_start(PROF_INTERVAL)
+#define __PROF_END()   prof_stop()
+#else
+#define __PROF_BEGIN()
+#define __PROF_END()
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#include <base.h>
+#include <tool.h>
+
+#define MCAUSE_IRQ        (1u << 31)
+#define IRQ_M_TIMER       7
+#define IRQ_M_EXT         11
+#define EXC_ECALL_M       11
+
+static Context* (*user_handler)(Event, Context*) = NULL;
+
+bool __prof_sample(Context *c) __attribute__((weak));
+
+/* Called from __am_asm_trap. On entry only ra, t0-t6, a0-a7, sp and the
+ * CSRs are in `c'; gp, tp and s0-s11 are filled in by the trap code only
+ * when the handler returns a different context to switch to. */
+Context* __am_irq_handle(Context *c) {
+  Event ev = {0};
+  if (c->mcause & MCAUSE_IRQ) {
+    switch (c->mcause & ~MCAUSE_IRQ) {
+      case IRQ_M_TIMER:
+        if (__prof_sample && __prof_sample(c)) return c;
+        ev.event = EVENT_IRQ_TIMER;
+        break;
+      case IRQ_M_EXT:   ev.event = EVENT_IRQ_IODEV; break;
+      default:          ev.event = EVENT_ERROR;     break;
+    }
+  } else if (c->mcause == EXC_ECALL_M) {
+    ev.event = c->SYS_NUM == (uintptr_t)-1 ? EVENT_YIELD : EVENT_SYSCALL;
+    c->mepc += 4;
+  } else {
+    ev.event = EVENT_ERROR;
+  }
+  ev.cause = c->mcause;
+
+  if (user_handler) {
+    c = user_handler(ev, c);
+    assert(c != NULL);
+  }
+  return c;
+}
+
+extern void __am_asm_trap(void);
+
+bool cte_init(Context*(*handler)(Event, Context*)) {
+  asm volatile("csrw mtvec, %0" : : "r"(__am_asm_trap));
+  user_handler = handler;
+  return true;
+}
+
+void yield() {
+  asm volatile("li a7, -1; ecall" : : : "a7", "memory");
+}
@@ -1,28 +1,109 @@
 #include <tool.h>
 #include <dev-mmio.h>
 
+/* Controller registers: offset, buffer and length, then a command write that
+ * starts the transfer. A controller with a status register reads nonzero at
+ * DISK_STATUS while a transfer is in flight (build libbase with
+ * -DDISK_HAS_STATUS); without one the transfer has completed by the time the
+ * command write returns, so requests finish as soon as they are started. */
+enum { DISK_OFFSET, DISK_BUF, DISK_LEN, DISK_CMD, DISK_STATUS };
+
+#define DISK_QUEUE_LEN 4  // power of two
+
+static volatile uint32_t *const diskctl = (uint32_t *)DISK_CTL_ADDR;
+
+// queue[q_head] is on the device whenever q_head != q_tail
+static disk_req_t *queue[DISK_QUEUE_LEN];
+static uint32_t q_head, q_tail;
+
+static bool device_busy() {
+#ifdef DISK_HAS_STATUS
+  return diskctl[DISK_STATUS] != 0;
+#else
+  return false;
+#endif
+}
+
+static void start(disk_req_t *req) {
+  diskctl[DISK_OFFSET] = req->offset;
+  diskctl[DISK_BUF]    = (uintptr_t)req->buf;
+  diskctl[DISK_LEN]    = req->len;
+  // the device must see the buffer as written before the command
+  asm volatile("fence iorw, iorw" : : : "memory");
+  req->state = DISK_REQ_BUSY;
+  diskctl[DISK_CMD] = req->cmd;
+}
+
+// retire the request on the device if it has finished and start the next
+static void advance() {
+  if (q_head == q_tail || device_busy()) return;
+  asm volatile("fence iorw, iorw" : : : "memory");
+  queue[q_head % DISK_QUEUE_LEN]->state = DISK_REQ_DONE;
+  if (++q_head != q_tail) start(queue[q_head % DISK_QUEUE_LEN]);
+}
+
+void disk_submit(disk_req_t *req) {
+  while (q_tail - q_head == DISK_QUEUE_LEN) advance();
+  req->state = DISK_REQ_QUEUED;
+  queue[q_tail++ % DISK_QUEUE_LEN] = req;
+  if (q_tail - q_head == 1) start(req);
+}
+
+bool disk_poll(disk_req_t *req) {
+  if (req->state != DISK_REQ_DONE) advance();
+  return req->state == DISK_REQ_DONE;
+}
+
+void disk_wait(disk_req_t *req) {
+  while (!disk_poll(req)) ;
+}
+
 /* read `len' bytes starting from `offset' of ramdisk into `buf' */
 uint64_t ramdisk_read(void *buf, uint64_t offset, uint64_t len) {
-  uint32_t *diskctl = (uint32_t *)DISK_CTL_ADDR;
-  
-  diskctl[0] = (uint32_t)offset;
-  diskctl[1] = (uint32_t)buf;
-  diskctl[2] = (uint32_t)len;
-  asm volatile("fence iorw, iorw");
-  diskctl[3] = 1;
-
+  disk_req_t req = { .buf = buf, .offset = offset, .len = len, .cmd = DISK_READ };
+  disk_submit(&req);
+  disk_wait(&req);
   return len;
 }
 
 /* write `len' bytes starting from `buf' into the `offset' of ramdisk */
 uint64_t ramdisk_write(const void *buf, uint64_t offset, uint64_t len) {
-  uint32_t *diskctl = (uint32_t *)DISK_CTL_ADDR;
-
-  diskctl[0] = (uint32_t)offset;
-  diskctl[1] = (uint32_t)buf;
-  diskctl[2] = (uint32_t)len;
-  asm volatile("fence.i");
-  diskctl[3] = 2;
-  
+  disk_req_t req = { .buf = (void *)buf, .offset = offset, .len = len, .cmd = DISK_WRITE };
+  disk_submit(&req);
+  disk_wait(&req);
   return len;
 }
+
+// queue a read of the stream's next block into buffer i; an empty request
+// (state DISK_REQ_IDLE) marks the end of the range
+static void stream_fill(disk_stream_t *s, int i) {
+  disk_req_t *r = &s->req[i];
+  uint32_t len = s->end - s->next < s->block ? s->end - s->next : s->block;
+  if (len == 0) { r->state = DISK_REQ_IDLE; return; }
+  *r = (disk_req_t) { .buf = s->buf[i], .offset = s->next, .len = len, .cmd = DISK_READ };
+  s->next += len;
+  disk_submit(r);
+}
+
+void disk_stream_open(disk_stream_t *s, void *buf0, void *buf1, uint32_t block,
+                      uint32_t offset, uint32_t len) {
+  s->buf[0] = buf0;
+  s->buf[1] = buf1;
+  s->block  = block;
+  s->next   = offset;
+  s->end    = offset + len;
+  s->cur    = 0;
+  stream_fill(s, 0);
+}
+
+void *disk_stream_next(disk_stream_t *s, uint32_t *len) {
+  disk_req_t *r = &s->req[s->cur];
+  if (r->state == DISK_REQ_IDLE) return NULL;
+  disk_wait(r);
+  // the other buffer was handed out by the previous call and is free again
+  stream_fill(s, s->cur ^ 1);
+  *len = r->len;
+  void *buf = s->buf[s->cur];
+  s->cur ^= 1;
+  return buf;
+}
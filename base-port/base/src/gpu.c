@@ -3,46 +3,161 @@
 #include <tool.h>
 
 #define SYNC_ADDR (VGACTL_ADDR + 4)
+// Optional dirty-rectangle registers for devices that can refresh a
+// sub-rectangle: (y0 << 16 | x0) and (y1 << 16 | x1), x1/y1 exclusive.
+#define SYNC_RECT_ADDR (VGACTL_ADDR + 8)
 
-void __gpu_init() {;
+// Video memory starts with the width*height frame; textures and canvas
+// nodes go after it, and the gpuptr_t values in a canvas tree are byte
+// offsets into it. Every frame write (FBDRAW, MEMCPY, RENDER) goes through
+// VMEM. By default that is the frame at FB_ADDR and nothing else, which
+// leaves no room for canvas trees, so GPU_RENDER is not offered. Build
+// with -DGPU_FFB_ALIAS on devices whose fast window at FFB_ADDR starts with
+// that same frame and holds GPU_VMEM_SIZE bytes of video memory in all.
+#ifdef GPU_FFB_ALIAS
+#ifndef GPU_VMEM_SIZE
+#define GPU_VMEM_SIZE (4 << 20)
+#endif
+#define VMEM      ((uint8_t *)(uintptr_t)FFB_ADDR)
+#define VMEM_SIZE ((uint32_t)GPU_VMEM_SIZE)
+#define HAS_ACCEL true
+#else
+#define VMEM      ((uint8_t *)(uintptr_t)FB_ADDR)
+#define VMEM_SIZE ((uint32_t)(screen_w * screen_h * sizeof(uint32_t)))
+#define HAS_ACCEL false
+#endif
 
+static int screen_w, screen_h;
+
+// union of everything drawn since the last sync; empty when x0 >= x1
+static struct { int x0, y0, x1, y1; } dirty;
+
+void __gpu_init() {
+  uint32_t size = inl(VGACTL_ADDR);
+  screen_w = (size >> 16) & 0x0ffff;
+  screen_h = size & 0x0ffff;
+  dirty.x0 = dirty.y0 = 0;
+  dirty.x1 = dirty.y1 = 0;
 }
 
 void __gpu_config(DEV_GPU_CONFIG_T *cfg) {
-  uint32_t size = inl(VGACTL_ADDR);
-  uint32_t w = (size >> 16) & 0x0ffff;
-  uint32_t h = size & 0x0ffff;
   *cfg = (DEV_GPU_CONFIG_T) {
-    .present = true, .has_accel = false,
-    .width = w, .height = h,
-    .vmemsz = 0
+    .present = true, .has_accel = HAS_ACCEL,
+    .width = screen_w, .height = screen_h,
+    .vmemsz = VMEM_SIZE
   };
 }
 
+static void mark_dirty(int x, int y, int w, int h) {
+  if (dirty.x0 >= dirty.x1) {
+    dirty.x0 = x;     dirty.y0 = y;
+    dirty.x1 = x + w; dirty.y1 = y + h;
+    return;
+  }
+  if (x < dirty.x0) dirty.x0 = x;
+  if (y < dirty.y0) dirty.y0 = y;
+  if (x + w > dirty.x1) dirty.x1 = x + w;
+  if (y + h > dirty.y1) dirty.y1 = y + h;
+}
+
+static void sync_dirty() {
+  if (dirty.x0 >= dirty.x1) return;
+#ifdef GPU_SYNC_RECT
+  outl(SYNC_RECT_ADDR,     (dirty.y0 << 16) | dirty.x0);
+  outl(SYNC_RECT_ADDR + 4, (dirty.y1 << 16) | dirty.x1);
+#endif
+  outl(SYNC_ADDR, 1);
+  dirty.x1 = dirty.x0;
+}
+
 void __gpu_fbdraw(DEV_GPU_FBDRAW_T *ctl) {
-  bool sync = ctl->sync;
-  int x = ctl->x; 
-  int y = ctl->y;
-  int w = ctl->w;
-  int h = ctl->h;
-  uint32_t *pixels = ctl->pixels;
-  uint32_t size = inl(VGACTL_ADDR);
-  uint32_t W = (size >> 16) & 0x0ffff;
-  uint32_t H = size & 0x0ffff;
-  uint32_t *fb = (uint32_t *)(uintptr_t)FB_ADDR;
-  
-  for(int i = 0; i < h; i++){
-    for(int j = 0; j < w; j++){
-      if(y + i >= H || x + j >= W) continue;
-      fb[(y + i) * W + x + j] = pixels[i * w + j];
-    }
+  int x = ctl->x, y = ctl->y, w = ctl->w, h = ctl->h;
+  const uint32_t *src = ctl->pixels;
+  int stride = w;
+
+  // clip once against the screen, then copy whole row spans
+  if (x < 0) { src -= x; w += x; x = 0; }
+  if (y < 0) { src -= y * stride; h += y; y = 0; }
+  if (x + w > screen_w) w = screen_w - x;
+  if (y + h > screen_h) h = screen_h - y;
+
+  if (w > 0 && h > 0) {
+    uint32_t *dst = (uint32_t *)VMEM + y * screen_w + x;
+    for (int i = 0; i < h; i++, dst += screen_w, src += stride)
+      memcpy(dst, src, w * sizeof(uint32_t));
+    mark_dirty(x, y, w, h);
   }
-  if(sync){
-    outl(SYNC_ADDR, 1);
-    return;
+
+  if (ctl->sync) sync_dirty();
+}
+
+// bulk copy into video memory; whole rows of the frame it covers are dirty
+void __gpu_memcpy(DEV_GPU_MEMCPY_T *params) {
+  uint32_t dest = params->dest, size = params->size;
+  panic_on(size > VMEM_SIZE || dest > VMEM_SIZE - size,
+           "GPU_MEMCPY out of video memory");
+  memcpy(VMEM + dest, params->src, size);
+
+  uint32_t frame_bytes = screen_w * screen_h * sizeof(uint32_t);
+  if (size && dest < frame_bytes) {
+    uint32_t last = (dest + size < frame_bytes ? dest + size : frame_bytes) - 1;
+    int y0 = dest / sizeof(uint32_t) / screen_w;
+    int y1 = last / sizeof(uint32_t) / screen_w + 1;
+    mark_dirty(0, y0, screen_w, y1 - y0);
   }
 }
 
+// Draw a texture into the w*h box at (x, y) of the frame, scaled by nearest
+// neighbour, keeping only the part inside the clip box [x0, x1) x [y0, y1).
+static void blit_texture(const struct gpu_texturedesc *t, int x, int y, int w, int h,
+                         int x0, int y0, int x1, int y1) {
+  int tw = t->w, th = t->h;
+  uint64_t bytes = (uint64_t)tw * th * sizeof(uint32_t);
+  panic_on(t->pixels > VMEM_SIZE || bytes > VMEM_SIZE - t->pixels,
+           "gpu_texture out of video memory");
+  const uint32_t *src = (const uint32_t *)(VMEM + t->pixels);
+  uint32_t *dst = (uint32_t *)VMEM + y0 * screen_w;
+  for (int r = y0; r < y1; r++, dst += screen_w) {
+    const uint32_t *row = src + (h == th ? r - y : (r - y) * th / h) * tw;
+    if (w == tw)
+      memcpy(dst + x0, row + (x0 - x), (x1 - x0) * sizeof(uint32_t));
+    else
+      for (int c = x0; c < x1; c++) dst[c] = row[(c - x) * tw / w];
+  }
+}
+
+// Render a sibling list. Each node is placed at (x1, y1) relative to its
+// parent with size w1*h1; a subtree's children are clipped to its w*h.
+static void render(gpuptr_t node, int ox, int oy, int cx0, int cy0, int cx1, int cy1) {
+  while (node != GPU_NULL) {
+    panic_on(node > VMEM_SIZE - sizeof(struct gpu_canvas), "gpu_canvas out of video memory");
+    const struct gpu_canvas *c = (const struct gpu_canvas *)(VMEM + node);
+    int x = ox + c->x1, y = oy + c->y1, w = c->w1, h = c->h1;
+    if (c->type == GPU_SUBTREE) {
+      if (c->w < w) w = c->w;
+      if (c->h < h) h = c->h;
+    }
+    int x0 = x > cx0 ? x : cx0, x1 = x + w < cx1 ? x + w : cx1;
+    int y0 = y > cy0 ? y : cy0, y1 = y + h < cy1 ? y + h : cy1;
+    if (x0 < x1 && y0 < y1) {
+      switch (c->type) {
+        case GPU_TEXTURE: blit_texture(&c->texture, x, y, c->w1, c->h1, x0, y0, x1, y1); break;
+        case GPU_SUBTREE: render(c->child, x, y, x0, y0, x1, y1); break;
+        default: panic("bad gpu_canvas type");
+      }
+      mark_dirty(x0, y0, x1 - x0, y1 - y0);
+    }
+    node = c->sibling;
+  }
+}
+
+// render the canvas tree at `root' into the frame and show it
+void __gpu_render(DEV_GPU_RENDER_T *params) {
+  panic_on(!HAS_ACCEL, "GPU_RENDER needs GPU_FFB_ALIAS");
+  render(params->root, 0, 0, 0, 0, screen_w, screen_h);
+  sync_dirty();
+}
+
 void __gpu_status(DEV_GPU_STATUS_T *status) {
   status->ready = true;
-}
\ No newline at end of file
+}
@@ -11,6 +11,8 @@ void __timer_rtc    (DEV_TIMER_RTC_T *);
 void __gpu_config   (DEV_GPU_CONFIG_T *);
 void __gpu_status   (DEV_GPU_STATUS_T *);
 void __gpu_fbdraw   (DEV_GPU_FBDRAW_T *);
+void __gpu_memcpy   (DEV_GPU_MEMCPY_T *);
+void __gpu_render   (DEV_GPU_RENDER_T *);
 
 void __timer_config (DEV_TIMER_CONFIG_T *cfg) { cfg->present = true; cfg->has_rtc = true; }
 void __input_config (DEV_INPUT_CONFIG_T *cfg) { cfg->present = true;  }
@@ -26,6 +28,8 @@ static void *lut[128] = {
   [DEV_GPU_CONFIG  ] = __gpu_config,
   [DEV_GPU_FBDRAW  ] = __gpu_fbdraw,
   [DEV_GPU_STATUS  ] = __gpu_status,
+  [DEV_GPU_MEMCPY  ] = __gpu_memcpy,
+  [DEV_GPU_RENDER  ] = __gpu_render,
   [DEV_UART_CONFIG ] = __uart_config,
 };
 
@@ -0,0 +1,80 @@
+#include <base.h>
+#include <tool.h>
+#include <perf.h>
+#include <dev-mmio.h>
+
+/* Statistical profiler. Every `interval' mtime ticks the machine timer
+ * interrupt records mepc in an open-addressed pc -> count table, and halt()
+ * dumps the table for script/prof.py to symbolize. */
+
+#define PROF_SLOTS 1024   // power of two
+#define MIE_MTIE   (1u << 7)
+#define MSTATUS_MIE (1u << 3)
+
+static struct {
+  uintptr_t pc;
+  uint32_t count;
+} table[PROF_SLOTS];
+static uint32_t nr_samples, nr_dropped;
+static uint32_t interval;
+
+static uint64_t mtime() {
+  uint32_t hi, lo;
+  do {
+    hi = inl(CLINT_MTIME + 4);
+    lo = inl(CLINT_MTIME);
+  } while (hi != inl(CLINT_MTIME + 4));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void set_mtimecmp(uint64_t t) {
+  // park the high word first so no intermediate value fires early
+  outl(CLINT_MTIMECMP + 4, 0xffffffff);
+  outl(CLINT_MTIMECMP, (uint32_t)t);
+  outl(CLINT_MTIMECMP + 4, (uint32_t)(t >> 32));
+}
+
+/* called from __am_irq_handle on a machine timer interrupt */
+bool __prof_sample(Context *c) {
+  if (interval == 0) return false;
+  uint32_t h = (c->mepc >> 2) * 2654435761u;
+  int i;
+  for (i = 0; i < PROF_SLOTS; i++) {
+    int k = (h + i) & (PROF_SLOTS - 1);
+    if (table[k].pc == c->mepc || table[k].count == 0) {
+      table[k].pc = c->mepc;
+      table[k].count++;
+      break;
+    }
+  }
+  if (i == PROF_SLOTS) nr_dropped++;
+  nr_samples++;
+  set_mtimecmp(mtime() + interval);
+  return true;
+}
+
+extern void __am_asm_trap(void);
+
+void prof_start(uint32_t ticks) {
+  uintptr_t tvec;
+  asm volatile("csrr %0, mtvec" : "=r"(tvec));
+  if (tvec != (uintptr_t)__am_asm_trap) cte_init(NULL);
+  interval = ticks;
+  set_mtimecmp(mtime() + interval);
+  asm volatile("csrs mie, %0" : : "r"(MIE_MTIE));
+  asm volatile("csrs mstatus, %0" : : "r"(MSTATUS_MIE));
+}
+
+void prof_stop() {
+  asm volatile("csrc mie, %0" : : "r"(MIE_MTIE));
+}
+
+/* called from halt(); one "PROF <pc> <count>" line per sampled pc */
+void __prof_report() {
+  prof_stop();
+  if (nr_samples == 0) return;
+  printf("PROF begin samples=%d dropped=%d interval=%d\n", nr_samples, nr_dropped, interval);
+  for (int i = 0; i < PROF_SLOTS; i++)
+    if (table[i].count) printf("PROF %08x %d\n", table[i].pc, table[i].count);
+  printf("PROF end\n");
+}
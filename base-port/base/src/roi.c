@@ -0,0 +1,14 @@
+#include <tool.h>
+#include <perf.h>
+
+perf_snapshot __roi_begin, __roi_total;
+int __roi_count;
+
+/* called from halt(); only linked in when a program uses ROI_BEGIN/ROI_END */
+void __roi_report() {
+  if (__roi_count == 0) return;
+  printf("ROI cycles: %llu, instrs: %llu, IPC: ", __roi_total.cycles, __roi_total.instret);
+  print_ratio(__roi_total.instret, __roi_total.cycles, 5);
+  putch('\n');
+  printf("Startup cycles: %u\n", __startup_cycles);
+}
@@ -0,0 +1,43 @@
+#include <base.h>
+#include <dev-mmio.h>
+
+#define MIE_MSIE (1u << 3)
+
+extern char __nr_harts;
+
+/* Secondary harts wait in __hart_park until hart 0 publishes a new entry
+ * with harts_release(); each release runs the entry once per parked hart. */
+static void (*volatile hart_entry)(int);
+static volatile uint32_t hart_epoch;
+
+int hart_id() {
+  int id;
+  asm volatile("csrr %0, mhartid" : "=r"(id));
+  return id;
+}
+
+int num_harts() {
+  return (int)(uintptr_t)&__nr_harts;
+}
+
+void harts_release(void (*entry)(int hartid)) {
+  hart_entry = entry;
+  asm volatile("fence rw, rw");
+  hart_epoch++;
+  asm volatile("fence rw, rw");
+  // a machine software interrupt wakes the parked harts out of wfi
+  for (int i = 1; i < num_harts(); i++) outl(CLINT_MSIP + 4 * i, 1);
+}
+
+void __hart_park(int id) {
+  uint32_t seen = 0;
+  // only the pending bit is needed to leave wfi; mstatus.MIE stays clear
+  asm volatile("csrs mie, %0" : : "r"(MIE_MSIE));
+  while (1) {
+    while (hart_epoch == seen) asm volatile("wfi");
+    outl(CLINT_MSIP + 4 * id, 0);
+    seen = hart_epoch;
+    asm volatile("fence rw, rw");
+    hart_entry(id);
+  }
+}
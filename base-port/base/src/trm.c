@@ -3,6 +3,7 @@
 #endif
 #include <base.h>
 #include <dev-mmio.h>
+#include <perf.h>
 int main(int argc, const char *argv[]);
 static const char *argv[] = {ARGV, NULL};
 static const int argc = sizeof(argv) / sizeof(argv[0]);
@@ -15,17 +16,54 @@ extern char _pmem_start;
 
 Area heap = RANGE(&_heap_start, PMEM_END);
 
+/* Console output is staged in a buffer and written to the serial port on
+ * '\n', when the buffer fills, on flush() and in halt(). With
+ * -DSERIAL_WIDE_TX (for a TX FIFO that accepts word stores) four characters
+ * go out per 32-bit store, lowest byte first. Harts other than 0 write
+ * through unbuffered so their output cannot interleave inside the buffer. */
+#ifndef CONSOLE_BUF_SIZE
+#define CONSOLE_BUF_SIZE 256
+#endif
+
+static char console_buf[CONSOLE_BUF_SIZE];
+static uint32_t console_len;
+
+void flush() {
+  uint32_t i = 0;
+#ifdef SERIAL_WIDE_TX
+  for (; i + 4 <= console_len; i += 4) {
+    const uint8_t *p = (const uint8_t *)console_buf + i;
+    outl(SERIAL_PORT, p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24);
+  }
+#endif
+  for (; i < console_len; i++) outb(SERIAL_PORT, console_buf[i]);
+  console_len = 0;
+}
+
 void putch(char ch) {
-    // Lab6 TODO: implement serial port MMIO
-    // hint use `outb` function and SERIAL_PORT to access serial port
-    outb(SERIAL_PORT, ch);
+  if (hart_id() != 0) { outb(SERIAL_PORT, ch); return; }
+  console_buf[console_len++] = ch;
+  if (ch == '\n' || console_len == CONSOLE_BUF_SIZE) flush();
 }
+
+void __roi_report() __attribute__((weak));
+void __prof_report() __attribute__((weak));
+
 void halt(int code) {
-  asm volatile(".word 0x80000000" : :"r"(code));
+  if (__prof_report) __prof_report();
+  if (__roi_report) __roi_report();
+  if (hart_id() == 0) flush();
+  // the simulator takes the exit code from a0
+  register int a0 asm("a0") = code;
+  asm volatile(".word 0x80000000" : :"r"(a0));
   while(1);
 }
 
+// cycle CSR at _start, and cycles spent from there to main()
+uint32_t __boot_cycle, __startup_cycles;
+
 void call_main() {
+  __startup_cycles = read_cycle() - __boot_cycle;
   int ret = main(argc, argv);
   halt(ret);
 }
\ No newline at end of file
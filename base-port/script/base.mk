@@ -5,7 +5,7 @@ AR = $(CROSS_COMPILE)llvm-ar
 CC = $(CROSS_COMPILE)clang
 AS = $(CROSS_COMPILE)clang
 
-COMMON_FLAGS = -march=rv32im_zicsr_zifencei -mabi=ilp32 -Os --target=riscv32 -g
+COMMON_FLAGS = -march=rv32im_zicsr_zifencei -mabi=ilp32 -Os --target=riscv32 -g -msmall-data-limit=8
 
 CFLAGS = -MMD $(COMMON_FLAGS) $(INC_PATH)
 CFLAGS += -fno-asynchronous-unwind-tables -fno-builtin -fno-stack-protector 
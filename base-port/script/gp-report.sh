@@ -0,0 +1,27 @@
+#!/bin/bash
+# Before/after report for gp relaxation: builds and runs a benchmark with
+# GP_RELAX=0 and GP_RELAX=1 and prints static gp-relative accesses, .text
+# size, ROI instructions and the simulator's total cycles for both. Without
+# the simulator only the static columns are filled in.
+#
+# usage: gp-report.sh <benchmark dir>     e.g. gp-report.sh dhrystone
+
+dir=$1
+if [ -z "$dir" ]; then
+    echo "Usage: $0 <dir>"
+    exit 1
+fi
+
+target=run
+[ -f "$dir/../../Makefile" ] || target=image
+
+printf "%-9s %10s %12s %14s %14s\n" "GP_RELAX" "gp refs" ".text bytes" "ROI instrs" "Total cycles"
+for relax in 0 1; do
+    make -C "$dir" clean-all >/dev/null 2>&1
+    output=$(make -C "$dir" $target GP_RELAX=$relax 2>/dev/null | sed 's/\x1b\[[0-9;]*m//g')
+    gp=$(cat "$dir"/build/*-riscv32.txt 2>/dev/null | grep -c "(gp)")
+    text=$(llvm-size -A "$dir"/build/*-riscv32.elf 2>/dev/null | awk '$1 == ".text" {print $2}')
+    roi=$(echo "$output" | grep "ROI cycles:" | tail -n 1 | awk '{print $5}' | tr -cd '0-9')
+    total=$(echo "$output" | grep "Total cycles:" | tail -n 1 | awk '{print $3}' | tr -cd '0-9')
+    printf "%-9s %10s %12s %14s %14s\n" "$relax" "$gp" "${text:--}" "${roi:--}" "${total:--}"
+done
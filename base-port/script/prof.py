@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Symbolize the "PROF <pc> <count>" table printed at halt() by the sampling
+# profiler (base/src/prof.c) against the objdump listing of the image.
+#
+# usage: prof.py <image>.txt [run-output]     (run output defaults to stdin)
+
+import bisect
+import re
+import sys
+
+SYM = re.compile(r'^([0-9a-fA-F]+) <([^>]+)>:')
+
+
+def load_symbols(path):
+    syms = []
+    with open(path) as f:
+        for line in f:
+            m = SYM.match(line)
+            if m:
+                syms.append((int(m.group(1), 16), m.group(2)))
+    syms.sort()
+    return syms
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("usage: prof.py <image>.txt [run-output]")
+    syms = load_symbols(sys.argv[1])
+    addrs = [a for a, _ in syms]
+    out = open(sys.argv[2]) if len(sys.argv) > 2 else sys.stdin
+
+    funcs, header = {}, None
+    for line in out:
+        line = re.sub(r'\x1b\[[0-9;]*m', '', line).strip()
+        if line.startswith('PROF begin'):
+            header = line[len('PROF begin '):]
+            funcs = {}
+        elif line == 'PROF end':
+            continue
+        elif line.startswith('PROF ') and header:
+            _, pc, count = line.split()
+            i = bisect.bisect_right(addrs, int(pc, 16)) - 1
+            name = syms[i][1] if i >= 0 else '??'
+            funcs[name] = funcs.get(name, 0) + int(count)
+        else:
+            print(line)
+
+    if not header:
+        sys.exit("no PROF table in the output (was the image built with PROF=<ticks>?)")
+    total = sum(funcs.values())
+    print('profile: ' + header)
+    print('%8s %7s  %s' % ('samples', 'share', 'function'))
+    for name, n in sorted(funcs.items(), key=lambda kv: -kv[1]):
+        print('%8d %6.2f%%  %s' % (n, 100.0 * n / total, name))
+
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,5 @@
 CROSS_COMPILE := 
-COMMON_FLAGS  := --target=riscv32 -march=rv32im_zicsr_zifencei -mabi=ilp32 -g -fno-pic 
+COMMON_FLAGS  := --target=riscv32 -march=rv32im_zicsr_zifencei -mabi=ilp32 -g -fno-pic -msmall-data-limit=8 
 CFLAGS        += $(COMMON_FLAGS) -static -fdata-sections -ffunction-sections
 AFLAGS        += $(COMMON_FLAGS) 
 LDFLAGS       += -melf32lriscv -static --gc-sections -e _start
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef SYNC_H__
+#define SYNC_H__
+
+#include <tool.h>
+
+/* Header-only SMP primitives for harts 0..num_harts()-1.
+ *
+ * With the A extension (-march=..a.., __riscv_atomic) locks and counters are
+ * built on amoadd. Without it they fall back to algorithms that only need
+ * plain loads, stores and fences: Lamport's bakery for the lock, and a
+ * per-hart arrival flag for the barrier. Every primitive orders the memory
+ * accesses around it (acquire on entry, release on exit). */
+
+#ifndef SYNC_MAX_HARTS
+#define SYNC_MAX_HARTS 8
+#endif
+
+// the bakery lock and the barrier keep one slot per hart
+#if defined(NR_HARTS) && NR_HARTS > SYNC_MAX_HARTS
+#error "NR_HARTS exceeds SYNC_MAX_HARTS; raise SYNC_MAX_HARTS"
+#endif
+
+#define sync_fence() asm volatile("fence rw, rw" : : : "memory")
+
+#ifdef __riscv_atomic
+#define SYNC_VARIANT "amo"
+static inline uint32_t __amoadd(volatile uint32_t *p, uint32_t v) {
+  uint32_t old;
+  asm volatile("amoadd.w.aqrl %0, %2, (%1)" : "=r"(old) : "r"(p), "r"(v) : "memory");
+  return old;
+}
+#else
+#define SYNC_VARIANT "bakery"
+#endif
+
+// ticket spinlock: harts acquire in the order they arrive
+
+typedef struct {
+#ifdef __riscv_atomic
+  volatile uint32_t next, serving;
+#else
+  volatile uint8_t  choosing[SYNC_MAX_HARTS];
+  volatile uint32_t number[SYNC_MAX_HARTS];
+#endif
+} spinlock_t;
+
+#define SPINLOCK_INIT {0}
+
+static inline void spin_lock(spinlock_t *l) {
+#ifdef __riscv_atomic
+  uint32_t ticket = __amoadd(&l->next, 1);
+  while (l->serving != ticket) ;
+#else
+  int id = hart_id(), n = num_harts();
+  l->choosing[id] = 1;
+  sync_fence();
+  uint32_t max = 0;
+  for (int j = 0; j < n; j++)
+    if (l->number[j] > max) max = l->number[j];
+  l->number[id] = max + 1;
+  sync_fence();
+  l->choosing[id] = 0;
+  sync_fence();
+  for (int j = 0; j < n; j++) {
+    while (l->choosing[j]) ;
+    sync_fence();
+    uint32_t t;
+    while ((t = l->number[j]) != 0 &&
+           (t < l->number[id] || (t == l->number[id] && j < id))) ;
+  }
+#endif
+  sync_fence();
+}
+
+static inline void spin_unlock(spinlock_t *l) {
+  sync_fence();
+#ifdef __riscv_atomic
+  l->serving = l->serving + 1;
+#else
+  l->number[hart_id()] = 0;
+#endif
+}
+
+// atomic counter
+
+typedef struct {
+  volatile uint32_t value;
+#ifndef __riscv_atomic
+  spinlock_t lock;
+#endif
+} atomic_counter_t;
+
+static inline uint32_t counter_fetch_add(atomic_counter_t *c, uint32_t v) {
+#ifdef __riscv_atomic
+  return __amoadd(&c->value, v);
+#else
+  spin_lock(&c->lock);
+  uint32_t old = c->value;
+  c->value = old + v;
+  spin_unlock(&c->lock);
+  return old;
+#endif
+}
+
+static inline uint32_t counter_read(atomic_counter_t *c) {
+  uint32_t v = c->value;
+  sync_fence();
+  return v;
+}
+
+// sense-reversing barrier for harts 0..n-1
+
+typedef struct {
+  volatile uint32_t sense;
+  uint8_t local[SYNC_MAX_HARTS];
+#ifdef __riscv_atomic
+  volatile uint32_t count;
+#else
+  volatile uint8_t arrived[SYNC_MAX_HARTS];
+#endif
+} barrier_t;
+
+static inline void barrier_wait(barrier_t *b, int n) {
+  int id = hart_id();
+  uint32_t sense = b->local[id] ^= 1;
+  sync_fence();
+#ifdef __riscv_atomic
+  if (__amoadd(&b->count, 1) == n - 1) {
+    b->count = 0;
+    sync_fence();
+    b->sense = sense;
+  }
+#else
+  b->arrived[id] = sense;
+  if (id == 0) {
+    for (int j = 1; j < n; j++) while (b->arrived[j] != sense) ;
+    sync_fence();
+    b->sense = sense;
+  }
+#endif
+  while (b->sense != sense) ;
+  sync_fence();
+}
+
+// single-producer/single-consumer ring of words; size must be a power of two
+
+typedef struct {
+  volatile uint32_t head, tail;
+  uint32_t size;
+  uintptr_t *buf;
+} spsc_ring_t;
+
+#define SPSC_RING_INIT(storage) { .size = LENGTH(storage), .buf = (storage) }
+
+static inline bool spsc_push(spsc_ring_t *r, uintptr_t v) {
+  uint32_t head = r->head;
+  if (head - r->tail == r->size) return false;
+  sync_fence();   // the slot is free only once the consumer's read is done
+  r->buf[head & (r->size - 1)] = v;
+  sync_fence();
+  r->head = head + 1;
+  return true;
+}
+
+static inline bool spsc_pop(spsc_ring_t *r, uintptr_t *v) {
+  uint32_t tail = r->tail;
+  if (r->head == tail) return false;
+  sync_fence();
+  *v = r->buf[tail & (r->size - 1)];
+  sync_fence();
+  r->tail = tail + 1;
+  return true;
+}
+
+#endif
@@ -27,11 +27,62 @@ char  *strchr    (const char *s, int c);
 char  *strrchr   (const char *s, int c);
 
 // stdio.h
+typedef void (*printf_sink_t)(void *ctx, const char *buf, size_t len);
 int    printf    (const char *format, ...);
 int    sprintf   (char *str, const char *format, ...);
 int    snprintf  (char *str, size_t size, const char *format, ...);
 int    vsprintf  (char *str, const char *format, va_list ap);
 int    vsnprintf (char *str, size_t size, const char *format, va_list ap);
+int    vcbprintf (printf_sink_t sink, void *ctx, const char *format, va_list ap);
+int    print_ratio(uint64_t num, uint64_t den, int decimals);
+
+// stdlib.h
+typedef struct {
+  size_t heap_size;     // bytes managed, headers included
+  size_t in_use;        // bytes in allocated blocks, headers included
+  size_t peak;          // high-water mark of in_use
+  size_t free_bytes;    // sum of free payloads
+  size_t largest_free;  // largest free payload; 1 - largest/free is fragmentation
+  uint32_t free_blocks, nr_malloc, nr_free;
+} malloc_stats_t;
+void   malloc_init(Area area);
+void  *malloc    (size_t size);
+void   free      (void *ptr);
+void  *calloc    (size_t nmemb, size_t size);
+void  *realloc   (void *ptr, size_t size);
+void  *aligned_alloc(size_t align, size_t size);
+void   malloc_stats(malloc_stats_t *st);
+
+// arena: bump allocation with scoped reset, carved from heap on first use
+#define ARENA_ALIGN         64
+typedef struct { uintptr_t ptr, end; } arena_t;
+typedef uintptr_t arena_mark_t;
+extern arena_t __arena;
+void   arena_init(Area area);
+void  *__arena_refill(size_t size, size_t align);
+
+// fork-join over the harts started by _start; not reentrant
+typedef void (*hart_fn_t)(int hart, void *ctx);
+typedef void (*range_fn_t)(int begin, int end, void *ctx);
+void   run_on_all_harts(hart_fn_t fn, void *ctx);
+void   parallel_for(int begin, int end, int grain, range_fn_t fn, void *ctx);
+void   parallel_set_harts(int n);     // cap on harts parallel_for uses, 0 = all
+void   parallel_set_stealing(bool on);
+int    parallel_harts();
+
+static inline void *arena_alloc(size_t size, size_t align) {
+  uintptr_t p = ROUNDUP(__arena.ptr, align);
+  if (p + size > __arena.end) return __arena_refill(size, align);
+  __arena.ptr = p + size;
+  return (void *)p;
+}
+
+static inline arena_mark_t arena_mark() {
+  if (!__arena.end) __arena_refill(0, 1);
+  return __arena.ptr;
+}
+
+static inline void arena_reset(arena_mark_t mark) { __arena.ptr = mark; }
 
 
 #define panic_on(cond, s) \
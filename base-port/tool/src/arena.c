@@ -0,0 +1,29 @@
+#include <tool.h>
+
+// Bump arena.  arena_alloc() is inline in tool.h: round the pointer up,
+// bump it, and fall through here only when the request does not fit.  With
+// no explicit arena_init() the first refill carves ARENA_SIZE bytes out of
+// the heap through aligned_alloc(), so the arena and malloc coexist.
+
+#ifndef ARENA_SIZE
+#define ARENA_SIZE (1 << 20)
+#endif
+
+arena_t __arena;
+
+void arena_init(Area area) {
+  __arena.ptr = ROUNDUP(area.start, ARENA_ALIGN);
+  __arena.end = (uintptr_t)area.end;
+  panic_on(__arena.ptr >= __arena.end, "arena too small");
+}
+
+void *__arena_refill(size_t size, size_t align) {
+  if (!__arena.end) {
+    void *p = aligned_alloc(ARENA_ALIGN, ARENA_SIZE);
+    panic_on(!p, "no heap for the arena");
+    arena_init((Area) { p, (char *)p + ARENA_SIZE });
+    return arena_alloc(size, align);
+  }
+  panic("arena exhausted");
+  return NULL;
+}
@@ -13,19 +13,83 @@ typedef union
     du_int all;
     struct
     {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        su_int low;
+        su_int high;
+#else
         su_int high;
         su_int low;
+#endif
     }s;
 } udwords;
 #  include <limits.h>
 COMPILER_RT_ABI di_int __divdi3(di_int a, di_int b);
 COMPILER_RT_ABI du_int __udivmoddi4(du_int a, du_int b, du_int* rem);
 
+/* Fast paths: most 64-bit divisions here (timer and cycle arithmetic) have
+ * operands that fit in 32 bits, which a single divu/remu handles, or a
+ * 32-bit divisor, which udiv64_32 handles with a few 32-bit divides instead
+ * of the bit-at-a-time loop in __udivmoddi4. */
+
+#define FITS_32(x)  (((x) >> 32) == 0)
+#define FITS_S32(x) ((x) == (di_int)(si_int)(x))
+
+/* Returns: (u1:u0) / v, *r = (u1:u0) % v; requires u1 < v (so the quotient
+ * fits in 32 bits). Hacker's Delight divlu: normalise v, then two steps of
+ * 32/16-bit schoolbook division with quotient digit correction. */
+
+static su_int
+udiv64_32(su_int u1, su_int u0, su_int v, su_int* r)
+{
+    const su_int b = 1u << 16;
+    su_int vn1, vn0, un32, un21, un10, un1, un0, q1, q0, rhat;
+    int s = __builtin_clz(v);
+
+    v <<= s;
+    vn1 = v >> 16;
+    vn0 = v & 0xffff;
+    un32 = (u1 << s) | (s ? u0 >> (32 - s) : 0);
+    un10 = u0 << s;
+    un1 = un10 >> 16;
+    un0 = un10 & 0xffff;
+
+    q1 = un32 / vn1;
+    rhat = un32 - q1 * vn1;
+    while (q1 >= b || q1 * vn0 > b * rhat + un1)
+    {
+        q1--;
+        rhat += vn1;
+        if (rhat >= b)
+            break;
+    }
+    un21 = un32 * b + un1 - q1 * v;
+
+    q0 = un21 / vn1;
+    rhat = un21 - q0 * vn1;
+    while (q0 >= b || q0 * vn0 > b * rhat + un0)
+    {
+        q0--;
+        rhat += vn1;
+        if (rhat >= b)
+            break;
+    }
+    *r = (un21 * b + un0 - q0 * v) >> s;
+    return q1 * b + q0;
+}
+
 /* Returns: a / b */
 
 COMPILER_RT_ABI di_int
 __divdi3(di_int a, di_int b)
 {
+    if (FITS_S32(a) && FITS_S32(b))
+    {
+        /* divide magnitudes so that INT_MIN / -1 cannot overflow */
+        su_int ua = a < 0 ? -(su_int)a : (su_int)a;
+        su_int ub = b < 0 ? -(su_int)b : (su_int)b;
+        du_int q = ua / ub;
+        return (a < 0) != (b < 0) ? -(di_int)q : (di_int)q;
+    }
     const int bits_in_dword_m1 = (int)(sizeof(di_int) * CHAR_BIT) - 1;
     di_int s_a = a >> bits_in_dword_m1;           /* s_a = a < 0 ? -1 : 0 */
     di_int s_b = b >> bits_in_dword_m1;           /* s_b = b < 0 ? -1 : 0 */
@@ -50,6 +114,13 @@ __divmoddi4(di_int a, di_int b, di_int* rem)
 COMPILER_RT_ABI di_int
 __moddi3(di_int a, di_int b)
 {
+    if (FITS_S32(a) && FITS_S32(b))
+    {
+        su_int ua = a < 0 ? -(su_int)a : (su_int)a;
+        su_int ub = b < 0 ? -(su_int)b : (su_int)b;
+        di_int r = ua % ub;
+        return a < 0 ? -r : r;
+    }
     const int bits_in_dword_m1 = (int)(sizeof(di_int) * CHAR_BIT) - 1;
     di_int s = b >> bits_in_dword_m1;  /* s = b < 0 ? -1 : 0 */
     b = (b ^ s) - s;                   /* negate if s == -1 */
@@ -65,6 +136,8 @@ __moddi3(di_int a, di_int b)
 COMPILER_RT_ABI du_int
 __udivdi3(du_int a, du_int b)
 {
+    if (FITS_32(a) && FITS_32(b))
+        return (su_int)a / (su_int)b;
     return __udivmoddi4(a, b, 0);
 }
 
@@ -73,6 +146,8 @@ __udivdi3(du_int a, du_int b)
 COMPILER_RT_ABI du_int
 __umoddi3(du_int a, du_int b)
 {
+    if (FITS_32(a) && FITS_32(b))
+        return (su_int)a % (su_int)b;
     du_int r;
     __udivmoddi4(a, b, &r);
     return r;
@@ -112,6 +187,20 @@ __udivmoddi4(du_int a, du_int b, du_int* rem)
         return 0;
     }
     /* n.s.high != 0 */
+    if (d.s.high == 0 && d.s.low != 0)
+    {
+        /* K X
+         * ---
+         * 0 K
+         * high quotient word by one divu, low word by udiv64_32
+         */
+        su_int rl;
+        q.s.high = n.s.high / d.s.low;
+        q.s.low = udiv64_32(n.s.high % d.s.low, n.s.low, d.s.low, &rl);
+        if (rem)
+            *rem = rl;
+        return q.all;
+    }
     if (d.s.low == 0)
     {
         if (d.s.high == 0)
@@ -174,87 +263,35 @@ __udivmoddi4(du_int a, du_int b, du_int* rem)
         r.s.high = n.s.high >> sr;
         r.s.low = (n.s.high << (n_uword_bits - sr)) | (n.s.low >> sr);
     }
-    else  /* d.s.low != 0 */
+    else  /* d.s.low != 0, d.s.high != 0 */
     {
-        if (d.s.high == 0)
+        /* K X
+         * ---
+         * K K
+         */
+        sr = __builtin_clz(d.s.high) - __builtin_clz(n.s.high);
+        /* 0 <= sr <= n_uword_bits - 1 or sr large */
+        if (sr > n_uword_bits - 1)
         {
-            /* K X
-             * ---
-             * 0 K
-             */
-            if ((d.s.low & (d.s.low - 1)) == 0)     /* if d is a power of 2 */
-            {
-                if (rem)
-                    *rem = n.s.low & (d.s.low - 1);
-                if (d.s.low == 1)
-                    return n.all;
-                sr = __builtin_ctz(d.s.low);
-                q.s.high = n.s.high >> sr;
-                q.s.low = (n.s.high << (n_uword_bits - sr)) | (n.s.low >> sr);
-                return q.all;
-            }
-            /* K X
-             * ---
-             * 0 K
-             */
-            sr = 1 + n_uword_bits + __builtin_clz(d.s.low) - __builtin_clz(n.s.high);
-            /* 2 <= sr <= n_udword_bits - 1
-             * q.all = n.all << (n_udword_bits - sr);
-             * r.all = n.all >> sr;
-             */
-            if (sr == n_uword_bits)
-            {
-                q.s.low = 0;
-                q.s.high = n.s.low;
-                r.s.high = 0;
-                r.s.low = n.s.high;
-            }
-            else if (sr < n_uword_bits)  // 2 <= sr <= n_uword_bits - 1
-            {
-                q.s.low = 0;
-                q.s.high = n.s.low << (n_uword_bits - sr);
-                r.s.high = n.s.high >> sr;
-                r.s.low = (n.s.high << (n_uword_bits - sr)) | (n.s.low >> sr);
-            }
-            else              // n_uword_bits + 1 <= sr <= n_udword_bits - 1
-            {
-                q.s.low = n.s.low << (n_udword_bits - sr);
-                q.s.high = (n.s.high << (n_udword_bits - sr)) |
-                           (n.s.low >> (sr - n_uword_bits));
-                r.s.high = 0;
-                r.s.low = n.s.high >> (sr - n_uword_bits);
-            }
+            if (rem)
+                *rem = n.all;
+            return 0;
+        }
+        ++sr;
+        /* 1 <= sr <= n_uword_bits */
+        /*  q.all = n.all << (n_udword_bits - sr); */
+        q.s.low = 0;
+        if (sr == n_uword_bits)
+        {
+            q.s.high = n.s.low;
+            r.s.high = 0;
+            r.s.low = n.s.high;
         }
         else
         {
-            /* K X
-             * ---
-             * K K
-             */
-            sr = __builtin_clz(d.s.high) - __builtin_clz(n.s.high);
-            /* 0 <= sr <= n_uword_bits - 1 or sr large */
-            if (sr > n_uword_bits - 1)
-            {
-                if (rem)
-                    *rem = n.all;
-                return 0;
-            }
-            ++sr;
-            /* 1 <= sr <= n_uword_bits */
-            /*  q.all = n.all << (n_udword_bits - sr); */
-            q.s.low = 0;
-            if (sr == n_uword_bits)
-            {
-                q.s.high = n.s.low;
-                r.s.high = 0;
-                r.s.low = n.s.high;
-            }
-            else
-            {
-                q.s.high = n.s.low << (n_uword_bits - sr);
-                r.s.high = n.s.high >> sr;
-                r.s.low = (n.s.high << (n_uword_bits - sr)) | (n.s.low >> sr);
-            }
+            q.s.high = n.s.low << (n_uword_bits - sr);
+            r.s.high = n.s.high >> sr;
+            r.s.low = (n.s.high << (n_uword_bits - sr)) | (n.s.low >> sr);
         }
     }
     /* Not a special case
@@ -0,0 +1,295 @@
+#include <tool.h>
+
+// Two-level segregated fit (TLSF) allocator over the `heap` Area.
+//
+// Free blocks are binned by size into FL_COUNT power-of-two classes
+// (first level), each split into SL_COUNT linear subclasses (second
+// level).  A bitmap per level turns "find the smallest non-empty bin that
+// fits" into two find-first-set operations, so malloc and free are O(1).
+//
+// Each block carries a header just below its payload: a pointer to the
+// physically previous block (only meaningful while that block is free) and
+// the payload size, whose low two bits flag "this block is free" and
+// "previous block is free".  Free blocks keep their list links in the
+// payload.  The heap ends in a zero-sized used sentinel block.
+//
+// MALLOC_ALIGN_LOG2 selects the alignment of every returned pointer (and
+// the size granularity); build libtool with -DMALLOC_ALIGN_LOG2=4 for
+// 16-byte alignment.
+
+#ifndef MALLOC_ALIGN_LOG2
+#define MALLOC_ALIGN_LOG2 3
+#endif
+#define MALLOC_ALIGN  ((size_t)1 << MALLOC_ALIGN_LOG2)
+
+#define SL_LOG2       5
+#define SL_COUNT      (1 << SL_LOG2)
+#define FL_SHIFT      (SL_LOG2 + MALLOC_ALIGN_LOG2)
+#define FL_MAX        31
+#define FL_COUNT      (FL_MAX - FL_SHIFT + 1)
+#define SMALL_BLOCK   (1u << FL_SHIFT)
+
+#define BLOCK_FREE    1u
+#define PREV_FREE     2u
+#define FLAG_MASK     (BLOCK_FREE | PREV_FREE)
+
+typedef struct block {
+  struct block *prev_phys;  // physically previous block, valid if PREV_FREE
+  size_t size;              // payload bytes | BLOCK_FREE | PREV_FREE
+  struct block *next_free;  // free list links, overlaid on the payload
+  struct block *prev_free;
+} block_t;
+
+#define HDR_OFF       offsetof(block_t, next_free)
+#define HDR_SIZE      ROUNDUP(HDR_OFF, MALLOC_ALIGN)
+#define BLOCK_MIN     ROUNDUP(2 * sizeof(block_t *), MALLOC_ALIGN)
+#define BLOCK_MAX     ((size_t)1 << (FL_MAX - 1))
+
+_Static_assert(FL_COUNT <= 32, "first level bitmap overflow");
+_Static_assert(MALLOC_ALIGN >= sizeof(size_t), "flags need two free size bits");
+
+static struct {
+  uint32_t fl_bitmap;
+  uint32_t sl_bitmap[FL_COUNT];
+  block_t *blocks[FL_COUNT][SL_COUNT];
+  bool ready;
+  malloc_stats_t st;
+} ctl;
+
+static inline int fls_size(size_t x) {
+  return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl(x);
+}
+
+static inline void *to_ptr(block_t *b) { return (char *)b + HDR_OFF; }
+static inline block_t *from_ptr(void *p) { return (block_t *)((char *)p - HDR_OFF); }
+static inline size_t bsize(block_t *b) { return b->size & ~(size_t)FLAG_MASK; }
+
+static inline block_t *next_phys(block_t *b) {
+  return from_ptr((char *)to_ptr(b) + bsize(b) + HDR_SIZE);
+}
+
+static inline size_t adjust(size_t size) {
+  size = ROUNDUP(size, MALLOC_ALIGN);
+  return size < BLOCK_MIN ? BLOCK_MIN : size;
+}
+
+static inline void mapping(size_t size, int *fl, int *sl) {
+  if (size < SMALL_BLOCK) {
+    *fl = 0;
+    *sl = size >> MALLOC_ALIGN_LOG2;
+  } else {
+    int f = fls_size(size);
+    *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+    *fl = f - FL_SHIFT + 1;
+  }
+}
+
+// round up to the next bin boundary, so any block found there fits
+static inline void mapping_search(size_t size, int *fl, int *sl) {
+  if (size >= SMALL_BLOCK) size += ((size_t)1 << (fls_size(size) - SL_LOG2)) - 1;
+  mapping(size, fl, sl);
+}
+
+static void insert_free(block_t *b) {
+  int fl, sl;
+  mapping(bsize(b), &fl, &sl);
+  block_t *head = ctl.blocks[fl][sl];
+  b->next_free = head;
+  b->prev_free = NULL;
+  if (head) head->prev_free = b;
+  ctl.blocks[fl][sl] = b;
+  ctl.fl_bitmap |= 1u << fl;
+  ctl.sl_bitmap[fl] |= 1u << sl;
+}
+
+static void remove_free(block_t *b) {
+  int fl, sl;
+  mapping(bsize(b), &fl, &sl);
+  if (b->next_free) b->next_free->prev_free = b->prev_free;
+  if (b->prev_free) {
+    b->prev_free->next_free = b->next_free;
+  } else {
+    ctl.blocks[fl][sl] = b->next_free;
+    if (!b->next_free) {
+      ctl.sl_bitmap[fl] &= ~(1u << sl);
+      if (!ctl.sl_bitmap[fl]) ctl.fl_bitmap &= ~(1u << fl);
+    }
+  }
+}
+
+// take the head of the smallest non-empty bin that fits `size`
+static block_t *locate_free(size_t size) {
+  int fl, sl;
+  mapping_search(size, &fl, &sl);
+  if (fl >= FL_COUNT) return NULL;
+  uint32_t slmap = ctl.sl_bitmap[fl] & (~0u << sl);
+  if (!slmap) {
+    uint32_t flmap = fl + 1 < 32 ? ctl.fl_bitmap & (~0u << (fl + 1)) : 0;
+    if (!flmap) return NULL;
+    fl = __builtin_ctz(flmap);
+    slmap = ctl.sl_bitmap[fl];
+  }
+  sl = __builtin_ctz(slmap);
+  block_t *b = ctl.blocks[fl][sl];
+  remove_free(b);
+  return b;
+}
+
+// b is marked free but on no list: coalesce with free neighbours and bin it
+static void release(block_t *b) {
+  if (b->size & PREV_FREE) {
+    block_t *prev = b->prev_phys;
+    remove_free(prev);
+    prev->size += bsize(b) + HDR_SIZE;
+    b = prev;
+  }
+  block_t *next = next_phys(b);
+  if (next->size & BLOCK_FREE) {
+    remove_free(next);
+    b->size += bsize(next) + HDR_SIZE;
+    next = next_phys(b);
+  }
+  next->prev_phys = b;
+  next->size |= PREV_FREE;
+  insert_free(b);
+}
+
+// give the tail of a used block beyond `size` back to the heap
+static void trim(block_t *b, size_t size) {
+  if (bsize(b) < size + HDR_SIZE + BLOCK_MIN) return;
+  block_t *rest = from_ptr((char *)to_ptr(b) + size + HDR_SIZE);
+  rest->size = (bsize(b) - size - HDR_SIZE) | BLOCK_FREE;
+  b->size = size | (b->size & FLAG_MASK);
+  release(rest);
+}
+
+static void *use(block_t *b, size_t size) {
+  b->size &= ~(size_t)BLOCK_FREE;
+  next_phys(b)->size &= ~(size_t)PREV_FREE;
+  trim(b, size);
+  ctl.st.in_use += bsize(b) + HDR_SIZE;
+  if (ctl.st.in_use > ctl.st.peak) ctl.st.peak = ctl.st.in_use;
+  ctl.st.nr_malloc++;
+  return to_ptr(b);
+}
+
+void malloc_init(Area area) {
+  memset(&ctl, 0, sizeof(ctl));
+  uintptr_t p = ROUNDUP((uintptr_t)area.start + HDR_OFF, MALLOC_ALIGN);
+  uintptr_t end = (uintptr_t)area.end;
+  ctl.ready = true;
+  if (end < p + HDR_SIZE + BLOCK_MIN) return;
+
+  size_t size = (end - p - HDR_SIZE) & ~(size_t)(MALLOC_ALIGN - 1);
+  if (size > BLOCK_MAX) size = BLOCK_MAX;
+  block_t *b = from_ptr((void *)p);
+  b->size = size | BLOCK_FREE;
+  block_t *sentinel = next_phys(b);
+  sentinel->size = PREV_FREE;
+  sentinel->prev_phys = b;
+  insert_free(b);
+  ctl.st.heap_size = size + HDR_SIZE;
+}
+
+void *malloc(size_t size) {
+  if (!ctl.ready) malloc_init(heap);
+  if (size == 0 || size > BLOCK_MAX) return NULL;
+  size = adjust(size);
+  block_t *b = locate_free(size);
+  return b ? use(b, size) : NULL;
+}
+
+void free(void *ptr) {
+  if (!ptr) return;
+  block_t *b = from_ptr(ptr);
+  assert(!(b->size & BLOCK_FREE));
+  ctl.st.in_use -= bsize(b) + HDR_SIZE;
+  ctl.st.nr_free++;
+  b->size |= BLOCK_FREE;
+  release(b);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  if (size && nmemb > (size_t)-1 / size) return NULL;
+  void *p = malloc(nmemb * size);
+  if (p) memset(p, 0, nmemb * size);
+  return p;
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (!ptr) return malloc(size);
+  if (size == 0) {
+    free(ptr);
+    return NULL;
+  }
+  if (size > BLOCK_MAX) return NULL;
+  block_t *b = from_ptr(ptr);
+  size_t old = bsize(b);
+  size = adjust(size);
+
+  // grow into a free physical successor before moving
+  block_t *next = next_phys(b);
+  if (size > old && (next->size & BLOCK_FREE) && old + HDR_SIZE + bsize(next) >= size) {
+    remove_free(next);
+    b->size += bsize(next) + HDR_SIZE;
+    next_phys(b)->size &= ~(size_t)PREV_FREE;
+  }
+  if (size <= bsize(b)) {
+    trim(b, size);
+    ctl.st.in_use += bsize(b) - old;
+    if (ctl.st.in_use > ctl.st.peak) ctl.st.peak = ctl.st.in_use;
+    return ptr;
+  }
+
+  void *p = malloc(size);
+  if (!p) return NULL;
+  memcpy(p, ptr, old);
+  free(ptr);
+  return p;
+}
+
+void *aligned_alloc(size_t align, size_t size) {
+  if (align & (align - 1)) return NULL;
+  if (align <= MALLOC_ALIGN) return malloc(size);
+  if (!ctl.ready) malloc_init(heap);
+  if (size == 0 || size > BLOCK_MAX || align > BLOCK_MAX) return NULL;
+
+  // over-allocate so that a leading gap, if any, is big enough to be a
+  // free block of its own
+  size = adjust(size);
+  size_t gap_min = HDR_SIZE + BLOCK_MIN;
+  if (size + align + gap_min > BLOCK_MAX) return NULL;
+  block_t *b = locate_free(size + align + gap_min);
+  if (!b) return NULL;
+
+  uintptr_t p = (uintptr_t)to_ptr(b);
+  uintptr_t a = ROUNDUP(p, align);
+  if (a != p && a - p < gap_min) a = ROUNDUP(p + gap_min, align);
+  if (a != p) {
+    size_t gap = a - p;
+    block_t *nb = from_ptr((void *)a);
+    nb->size = (bsize(b) - gap) | BLOCK_FREE | PREV_FREE;
+    nb->prev_phys = b;
+    next_phys(nb)->prev_phys = nb;
+    b->size = (gap - HDR_SIZE) | BLOCK_FREE | (b->size & PREV_FREE);
+    insert_free(b);
+    b = nb;
+  }
+  return use(b, size);
+}
+
+void malloc_stats(malloc_stats_t *st) {
+  if (!ctl.ready) malloc_init(heap);
+  *st = ctl.st;
+  st->free_bytes = st->largest_free = st->free_blocks = 0;
+  for (int fl = 0; fl < FL_COUNT; fl++) {
+    for (int sl = 0; sl < SL_COUNT; sl++) {
+      for (block_t *b = ctl.blocks[fl][sl]; b; b = b->next_free) {
+        size_t sz = bsize(b);
+        st->free_bytes += sz;
+        st->free_blocks++;
+        if (sz > st->largest_free) st->largest_free = sz;
+      }
+    }
+  }
+}
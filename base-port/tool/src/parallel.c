@@ -0,0 +1,107 @@
+#include <tool.h>
+#include <sync.h>
+
+// Fork-join runtime.  run_on_all_harts() hands one function to every hart
+// through harts_release() and joins on a barrier.  parallel_for() splits
+// [begin, end) into one contiguous share per hart.  With stealing on, each
+// share becomes a locked range that its owner eats from the front in
+// `grain'-sized chunks while harts that run dry steal chunks off the back.
+
+static struct {
+  hart_fn_t fn;
+  void *ctx;
+} job;
+static barrier_t join;
+static int max_harts;
+static bool stealing;
+
+static struct share {
+  spinlock_t lock;
+  int lo, hi;
+} shares[SYNC_MAX_HARTS];
+
+static struct {
+  int grain, n;
+  range_fn_t fn;
+  void *ctx;
+} loop;
+
+void parallel_set_harts(int n) { max_harts = n; }
+void parallel_set_stealing(bool on) { stealing = on; }
+
+int parallel_harts() {
+  int n = num_harts();
+  return max_harts > 0 && max_harts < n ? max_harts : n;
+}
+
+static void run_job(int id) {
+  job.fn(id, job.ctx);
+  barrier_wait(&join, num_harts());
+}
+
+void run_on_all_harts(hart_fn_t fn, void *ctx) {
+  if (num_harts() == 1) {
+    fn(0, ctx);
+    return;
+  }
+  panic_on(num_harts() > SYNC_MAX_HARTS, "raise SYNC_MAX_HARTS");
+  job.fn = fn;
+  job.ctx = ctx;
+  harts_release(run_job);
+  run_job(0);
+}
+
+static bool take_front(struct share *s, int *b, int *e) {
+  spin_lock(&s->lock);
+  *b = s->lo;
+  *e = s->lo + loop.grain < s->hi ? s->lo + loop.grain : s->hi;
+  s->lo = *e;
+  spin_unlock(&s->lock);
+  return *b < *e;
+}
+
+static bool steal_back(struct share *s, int *b, int *e) {
+  spin_lock(&s->lock);
+  *e = s->hi;
+  *b = s->hi - loop.grain > s->lo ? s->hi - loop.grain : s->lo;
+  s->hi = *b;
+  spin_unlock(&s->lock);
+  return *b < *e;
+}
+
+static void run_share(int id, void *unused) {
+  if (id >= loop.n) return;
+  if (!stealing) {
+    loop.fn(shares[id].lo, shares[id].hi, loop.ctx);
+    return;
+  }
+  int b, e;
+  while (take_front(&shares[id], &b, &e)) loop.fn(b, e, loop.ctx);
+  for (int v = 1; v < loop.n; v++) {
+    struct share *victim = &shares[(id + v) % loop.n];
+    while (steal_back(victim, &b, &e)) loop.fn(b, e, loop.ctx);
+  }
+}
+
+void parallel_for(int begin, int end, int grain, range_fn_t fn, void *ctx) {
+  // shares[] has SYNC_MAX_HARTS slots and is filled before run_on_all_harts
+  panic_on(num_harts() > SYNC_MAX_HARTS, "raise SYNC_MAX_HARTS");
+  int len = end - begin;
+  int n = parallel_harts();
+  if (grain < 1) grain = 1;
+  if (n > (len + grain - 1) / grain) n = (len + grain - 1) / grain;
+  if (n <= 1) {
+    if (len > 0) fn(begin, end, ctx);
+    return;
+  }
+
+  loop.grain = grain;
+  loop.n = n;
+  loop.fn = fn;
+  loop.ctx = ctx;
+  for (int i = 0; i < n; i++) {
+    shares[i].lo = begin + (int)((int64_t)len * i / n);
+    shares[i].hi = begin + (int)((int64_t)len * (i + 1) / n);
+  }
+  run_on_all_harts(run_share, NULL);
+}
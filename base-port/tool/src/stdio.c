@@ -18,19 +18,129 @@ static int skip_atoi(const char **s){
   return i;
 }
 
-static char *number(char *str, long num, int base, int size, int precision, int type){
+
+// Formatted output is produced into a small chunk buffer and handed to a
+// sink whenever the chunk fills up (and once more at the end), so printf
+// streams straight to the console without staging the whole string.
+#define CHUNK_SIZE 64
+
+typedef struct {
+  printf_sink_t sink;
+  void *ctx;
+  int len;              // Characters produced so far
+  int pos;              // Fill level of buf
+  char buf[CHUNK_SIZE];
+} outbuf_t;
+
+static void flush_chunk(outbuf_t *o){
+  if (o->pos) o->sink(o->ctx, o->buf, o->pos);
+  o->pos = 0;
+}
+
+static inline void emit(outbuf_t *o, char c){
+  o->buf[o->pos++] = c;
+  o->len++;
+  if (o->pos == CHUNK_SIZE) flush_chunk(o);
+}
+
+static inline void pad(outbuf_t *o, char c, int n){
+  while (n-- > 0) emit(o, c);
+}
+
+static const char digit_pairs[201] =
+  "00010203040506070809101112131415161718192021222324"
+  "25262728293031323334353637383940414243444546474849"
+  "50515253545556575859606162636465666768697071727374"
+  "75767778798081828384858687888990919293949596979899";
+
+// x / 100 for any 32-bit x, as a high multiply and a shift instead of a divu
+static inline uint32_t div100(uint32_t x){
+  return (uint32_t)(((uint64_t)x * 0x51eb851fu) >> 37);
+}
+
+// Write the digits of num into tmp, least significant first; returns the
+// digit count. Power-of-two bases use shifts and masks, base 10 emits two
+// digits per step from digit_pairs, anything else divides.
+static int utoa_rev(char *tmp, uint32_t num, int base, const char *dig){
+  int i = 0;
+
+  switch (base){
+    case 16:
+      do { tmp[i++] = dig[num & 15]; num >>= 4; } while (num);
+      break;
+
+    case 8:
+      do { tmp[i++] = dig[num & 7]; num >>= 3; } while (num);
+      break;
+
+    case 10:
+      while (num >= 100){
+        uint32_t q = div100(num);
+        const char *d = &digit_pairs[2 * (num - q * 100)];
+        tmp[i++] = d[1];
+        tmp[i++] = d[0];
+        num = q;
+      }
+      if (num >= 10){
+        tmp[i++] = digit_pairs[2 * num + 1];
+        tmp[i++] = digit_pairs[2 * num];
+      }
+      else
+        tmp[i++] = '0' + num;
+      break;
+
+    default:
+      do { tmp[i++] = dig[num % base]; num /= base; } while (num);
+      break;
+  }
+  return i;
+}
+
+// 64-bit variant of utoa_rev. Only the digits above the low 32 bits need
+// 64-bit arithmetic: decimal peels off 9-digit chunks with at most two
+// 64-bit divides by 10^9 for any value, the rest goes through utoa_rev.
+static int ulltoa_rev(char *tmp, unsigned long long num, int base, const char *dig){
+  int i = 0, n;
+
+  switch (base){
+    case 16:
+      for (; num >> 32; num >>= 4) tmp[i++] = dig[num & 15];
+      break;
+
+    case 8:
+      for (; num >> 32; num >>= 3) tmp[i++] = dig[num & 7];
+      break;
+
+    case 10:
+      while (num >> 32){
+        unsigned long long q = num / 1000000000u;
+        n = utoa_rev(tmp + i, (uint32_t)(num - q * 1000000000u), 10, dig);
+        while (n < 9) tmp[i + n++] = '0';
+        i += 9;
+        num = q;
+      }
+      break;
+
+    default:
+      for (; num >> 32; num /= base) tmp[i++] = dig[num % base];
+      break;
+  }
+  return i + utoa_rev(tmp + i, (uint32_t)num, base, dig);
+}
+
+static void number(outbuf_t *o, unsigned long long num, int base, int size, int precision, int type){
   char c, sign, tmp[66];
   char *dig = digits;
   int i;
 
   if (type & LARGE)  dig = upper_digits;
   if (type & LEFT) type &= ~ZEROPAD;
-  if (base < 2 || base > 36) return 0;
+  if (base < 2 || base > 36) return;
  
   c = (type & ZEROPAD) ? '0' : ' ';
   sign = 0;
   if (type & SIGN){
-    if (num < 0){
+    if ((long long) num < 0){
       sign = '-';
       num = -num;
       size--;
@@ -52,40 +162,298 @@ static char *number(char *str, long num, int base, int size, int precision, int
       size--;
   }
 
-  i = 0;
-
-  if (num == 0)
-    tmp[i++] = '0';
-  else{
-    while (num != 0){
-      tmp[i++] = dig[((unsigned long) num) % (unsigned) base];
-      num = ((unsigned long) num) / (unsigned) base;
-    }
-  }
+  i = ulltoa_rev(tmp, num, base, dig);
 
   if (i > precision) precision = i;
   size -= precision;
-  if (!(type & (ZEROPAD | LEFT))) while (size-- > 0) *str++ = ' ';
-  if (sign) *str++ = sign;
+  if (!(type & (ZEROPAD | LEFT))){
+    pad(o, ' ', size);
+    size = 0;
+  }
+  if (sign) emit(o, sign);
  
   if (type & SPECIAL){
     if (base == 8)
-      *str++ = '0';
+      emit(o, '0');
     else if (base == 16){
-      *str++ = '0';
-      *str++ = digits[33];
+      emit(o, '0');
+      emit(o, digits[33]);
+    }
+  }
+
+  if (!(type & LEFT)){
+    pad(o, c, size);
+    size = 0;
+  }
+  pad(o, '0', precision - i);
+  while (i-- > 0) emit(o, tmp[i]);
+  pad(o, ' ', size);
+}
+
+// Floating point conversions work on the IEEE-754 bit pattern with integer
+// arithmetic only, so %e/%f never pull in soft-float routines. The value is
+// scaled by powers of ten into [1, 2^64) and its decimal digits are produced
+// on demand. While no bits have been lost the digits are exact (up to
+// FLOAT_DIGITS of them); after an inexact scaling step only FLOAT_INEXACT
+// significant digits are kept and the rest print as '0'. Those digits can be
+// off by a unit or two in the last place, so output of inexact values
+// matches correct rounding up to 15 significant digits; halfway cases are
+// settled by float_cmp_tie below rather than by the generated digits.
+#define FLOAT_DIGITS   40
+#define FLOAT_INEXACT  17
+#define FLOAT_MAX_PREC 40
+#define FLOAT_BUF      (310 + FLOAT_MAX_PREC + 2)
+
+typedef struct {
+  char dg[FLOAT_DIGITS];
+  int nd;               // Digits generated so far
+  int limit;            // Digits that carry information
+  uint64_t frac;        // Remaining fraction, in units of 2^-kf
+  int kf;
+  bool exact;
+} fdigits_t;
+
+static char float_digit(fdigits_t *f, int i){
+  if (i < 0 || i >= f->limit) return '0';
+  while (f->nd <= i){
+    f->frac *= 10;
+    f->dg[f->nd++] = '0' + (f->frac >> f->kf);
+    f->frac &= (1ull << f->kf) - 1;
+  }
+  return f->dg[i];
+}
+
+// True if digit i is the last non-zero digit of the exact value
+static bool float_last_digit(fdigits_t *f, int i){
+  if (!f->exact || i + 1 >= f->limit) return false;
+  for (int j = i + 1; j < f->limit; j++)
+    if (float_digit(f, j) != '0') return false;
+  return f->frac == 0;
+}
+
+// Set up digit generation for a finite, non-negative double and return the
+// position of the decimal point: value = 0.d0d1d2... * 10^ret.
+static int float_digits(fdigits_t *f, uint64_t bits){
+  uint64_t mant = bits & ((1ull << 52) - 1), q;
+  int exp2 = (bits >> 52) & 0x7ff;
+  int k, n, dexp = 0;
+  char tmp[24];
+
+  f->exact = true;
+  if (exp2){
+    mant |= 1ull << 52;
+    k = 1075 - exp2;
+  }
+  else
+    k = 1074;
+  if (mant == 0){
+    f->nd = f->limit = 0;
+    f->frac = 0;
+    return 1;
+  }
+
+  // value = mant * 2^-k with bit 63 of mant kept set
+  while (!(mant >> 63)) { mant <<= 1; k++; }
+  while (k < 0){              // >= 2^64: divide by ten
+    q = mant / 5;
+    if (mant - q * 5) f->exact = false;
+    mant = q + (mant - q * 5 >= 3);
+    k++;
+    dexp++;
+    while (!(mant >> 63)) { mant <<= 1; k++; }
+  }
+  while (k >= 64){            // < 1: multiply by ten
+    if (mant & 7) f->exact = false;
+    mant = ((mant >> 3) + ((mant >> 2) & 1)) * 5;
+    k -= 4;
+    dexp--;
+    while (!(mant >> 63)) { mant <<= 1; k++; }
+  }
+
+  // 0 <= k < 64: integer part and a fraction of at most 60 bits, so that
+  // multiplying it by ten cannot overflow
+  f->frac = mant & ((1ull << k) - 1);
+  f->kf = k;
+  if (k > 60){
+    if (f->frac & ((1ull << (k - 60)) - 1)) f->exact = false;
+    f->frac >>= k - 60;
+    f->kf = 60;
+  }
+  n = ulltoa_rev(tmp, mant >> k, 10, digits);
+  for (f->nd = 0; f->nd < n; f->nd++) f->dg[f->nd] = tmp[n - 1 - f->nd];
+  f->limit = f->exact ? FLOAT_DIGITS : FLOAT_INEXACT;
+  return n + dexp;
+}
+
+// Rounding ties are decided exactly even after an inexact scaling step: the
+// value mant * 2^e2 is compared with the halfway point (10m + 5) * 10^p by
+// big-integer arithmetic. 64 32-bit limbs cover the largest operands, about
+// 1300 bits for subnormals at FLOAT_MAX_PREC digits.
+#define BIG_LIMBS 64
+
+typedef struct {
+  int n;
+  uint32_t d[BIG_LIMBS];
+} big_t;
+
+static void big_mul_add(big_t *b, uint32_t m, uint32_t a){
+  uint64_t c = a;
+  for (int i = 0; i < b->n; i++){
+    c += (uint64_t)b->d[i] * m;
+    b->d[i] = c;
+    c >>= 32;
+  }
+  if (c) b->d[b->n++] = c;
+}
+
+static void big_shl(big_t *b, int s){
+  int w = s / 32, i;
+  s %= 32;
+  for (i = b->n - 1; i >= 0; i--) b->d[i + w] = b->d[i];
+  for (i = 0; i < w; i++) b->d[i] = 0;
+  b->n += w;
+  if (s){
+    uint32_t c = 0;
+    for (i = w; i < b->n; i++){
+      uint32_t v = b->d[i];
+      b->d[i] = (v << s) | c;
+      c = v >> (32 - s);
     }
+    if (c) b->d[b->n++] = c;
   }
+}
+
+static void big_pow10(big_t *b, int p){
+  static const uint32_t pow10[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  };
+  for (; p >= 9; p -= 9) big_mul_add(b, 1000000000, 0);
+  if (p) big_mul_add(b, pow10[p], 0);
+}
+
+static int big_cmp(big_t *a, big_t *b){
+  while (a->n && !a->d[a->n - 1]) a->n--;
+  while (b->n && !b->d[b->n - 1]) b->n--;
+  if (a->n != b->n) return a->n < b->n ? -1 : 1;
+  for (int i = a->n - 1; i >= 0; i--)
+    if (a->d[i] != b->d[i]) return a->d[i] < b->d[i] ? -1 : 1;
+  return 0;
+}
 
-  if (!(type & LEFT)) while (size-- > 0) *str++ = c;
-  while (i < precision--) *str++ = '0';
-  while (i-- > 0) *str++ = tmp[i];
-  while (size-- > 0) *str++ = ' ';
+// Sign of value - (10m + 5) * 10^p for a finite, non-negative double, where
+// m is the number written by the n digits in dg
+static int float_cmp_tie(uint64_t bits, const char *dg, int n, int p){
+  uint64_t mant = bits & ((1ull << 52) - 1);
+  int exp2 = (bits >> 52) & 0x7ff, e2;
+  big_t v = { .n = 0 }, t = { .n = 0 };
 
-  return str;
+  if (exp2){
+    mant |= 1ull << 52;
+    e2 = exp2 - 1075;
+  }
+  else
+    e2 = -1074;
+  v.d[v.n++] = mant;
+  v.d[v.n++] = mant >> 32;
+  for (int i = 0; i < n; i++) big_mul_add(&t, 10, dg[i] - '0');
+  big_mul_add(&t, 10, 5);
+
+  if (e2 > 0) big_shl(&v, e2); else big_shl(&t, -e2);
+  if (p > 0) big_pow10(&t, p); else big_pow10(&v, -p);
+  return big_cmp(&v, &t);
 }
 
-static char *eaddr(char *str, unsigned char *addr, int size, int precision, int type){
+static void fnumber(outbuf_t *o, uint64_t bits, int fmt, int size, int precision, int type){
+  fdigits_t f;
+  char buf[FLOAT_BUF + 1];
+  char *d = buf + 1;    // One byte of headroom for a carry out of the top digit
+  char sign = 0;
+  int n, i, lo, hi, point, exp10 = 0, len;
+  int is_exp = (fmt == 'e' || fmt == 'E');
+
+  if (type & LEFT) type &= ~ZEROPAD;
+  if (precision < 0) precision = 6;
+  if (precision > FLOAT_MAX_PREC) precision = FLOAT_MAX_PREC;
+
+  if (bits >> 63) sign = '-';
+  else if (type & PLUS) sign = '+';
+  else if (type & SPACE) sign = ' ';
+  if (sign) size--;
+
+  if (((bits >> 52) & 0x7ff) == 0x7ff){
+    const char *s = (bits & ((1ull << 52) - 1)) ? "nan" : "inf";
+    if (!(type & LEFT)) pad(o, ' ', size - 3);
+    if (sign) emit(o, sign);
+    for (i = 0; i < 3; i++) emit(o, (type & LARGE) ? s[i] - 'a' + 'A' : s[i]);
+    if (type & LEFT) pad(o, ' ', size - 3);
+    return;
+  }
+
+  point = float_digits(&f, bits & ~(1ull << 63));
+  if (is_exp){
+    lo = 0;
+    hi = precision;
+    exp10 = point - 1;
+  }
+  else{
+    lo = point > 0 ? 0 : point - 1;   // Always at least one integer digit
+    hi = point + precision - 1;
+  }
+
+  // Digits lo..hi, rounded to nearest on digit hi + 1 (ties to even)
+  for (i = lo; i <= hi; i++) d[i - lo] = float_digit(&f, i);
+  n = hi - lo + 1;
+  char next = float_digit(&f, hi + 1);
+  bool up = next > '5' || (next == '5' && (!float_last_digit(&f, hi + 1) || (d[n - 1] & 1)));
+  if (!f.exact && hi + 1 < f.limit && (next == '4' || next == '5')){
+    // the generated digits may sit on the wrong side of the halfway point
+    int c = float_cmp_tie(bits & ~(1ull << 63), d, n, point - hi - 2);
+    up = c > 0 || (c == 0 && (d[n - 1] & 1));
+  }
+  if (up){
+    for (i = n - 1; i >= 0 && d[i] == '9'; i--) d[i] = '0';
+    if (i >= 0)
+      d[i]++;
+    else{
+      *--d = '1';
+      if (is_exp)
+        exp10++;
+      else
+        n++;
+    }
+  }
+
+  // Integer digits, then '.' and precision fraction digits, then exponent
+  int ilen = is_exp ? 1 : n - precision;
+  int dot = (precision || (type & SPECIAL)) ? 1 : 0;
+  int eabs = exp10 < 0 ? -exp10 : exp10;
+  len = ilen + dot + precision;
+  if (is_exp) len += (eabs >= 100) ? 5 : 4;
+
+  size -= len;
+  if (!(type & (ZEROPAD | LEFT))){
+    pad(o, ' ', size);
+    size = 0;
+  }
+  if (sign) emit(o, sign);
+  if (!(type & LEFT)){
+    pad(o, '0', size);
+    size = 0;
+  }
+  for (i = 0; i < ilen; i++) emit(o, d[i]);
+  if (dot) emit(o, '.');
+  for (i = 0; i < precision; i++) emit(o, d[ilen + i]);
+  if (is_exp){
+    emit(o, (type & LARGE) ? 'E' : 'e');
+    emit(o, exp10 < 0 ? '-' : '+');
+    if (eabs >= 100) emit(o, '0' + eabs / 100);
+    emit(o, '0' + eabs / 10 % 10);
+    emit(o, '0' + eabs % 10);
+  }
+  pad(o, ' ', size);
+}
+
+static void eaddr(outbuf_t *o, unsigned char *addr, int size, int precision, int type){
   char tmp[24];
   char *dig = digits;
   int i, len;
@@ -98,14 +466,12 @@ static char *eaddr(char *str, unsigned char *addr, int size, int precision, int
     tmp[len++] = dig[addr[i] & 0x0F];
   }
 
-  if (!(type & LEFT)) while (len < size--) *str++ = ' ';
-  for (i = 0; i < len; ++i) *str++ = tmp[i];
-  while (len < size--) *str++ = ' ';
-
-  return str;
+  if (!(type & LEFT)) pad(o, ' ', size - len);
+  for (i = 0; i < len; ++i) emit(o, tmp[i]);
+  if (type & LEFT) pad(o, ' ', size - len);
 }
 
-static char *iaddr(char *str, unsigned char *addr, int size, int precision, int type){
+static void iaddr(outbuf_t *o, unsigned char *addr, int size, int precision, int type){
   char tmp[24];
   int i, n, len;
 
@@ -132,27 +498,71 @@ static char *iaddr(char *str, unsigned char *addr, int size, int precision, int
     }
   }
 
-  if (!(type & LEFT)) while (len < size--) *str++ = ' ';
-  for (i = 0; i < len; ++i) *str++ = tmp[i];
-  while (len < size--) *str++ = ' ';
+  if (!(type & LEFT)) pad(o, ' ', size - len);
+  for (i = 0; i < len; ++i) emit(o, tmp[i]);
+  if (type & LEFT) pad(o, ' ', size - len);
+}
 
-  return str;
+static void putch_sink(void *ctx, const char *buf, size_t len){
+  for (size_t i = 0; i < len; i++) putch(buf[i]);
 }
-char buffer[65536];
+
 int printf(const char *fmt, ...) {
   va_list ap;
   int n;
   va_start(ap, fmt);
-  n = vsprintf(buffer, fmt, ap);
+  n = vcbprintf(putch_sink, NULL, fmt, ap);
   va_end(ap);
-  char *p = buffer;
-  while(*p){
-    putch(*p);
-    p++;
-  }
   return n;
 }
 
+// Destination of sprintf/snprintf: `left' counts the room that remains,
+// one byte of which is always kept back for the terminating '\0'.
+typedef struct {
+  char *str;
+  size_t left;
+} strbuf_t;
+
+static void str_sink(void *ctx, const char *buf, size_t len){
+  strbuf_t *sb = ctx;
+  if (len >= sb->left) len = sb->left ? sb->left - 1 : 0;
+  memcpy(sb->str, buf, len);
+  sb->str += len;
+  sb->left -= len;
+}
+
+// Print num / den with `decimals' digits after the point, rounded half up,
+// e.g. IPC as print_ratio(instret, cycles, 3). Integer arithmetic only.
+int print_ratio(uint64_t num, uint64_t den, int decimals){
+  char frac[20];
+  uint64_t q, r;
+  int i;
+
+  if (den == 0) return printf("inf");
+  if (decimals < 0) decimals = 0;
+  if (decimals > 18) decimals = 18;
+  while (den > (1ull << 59)){   // Keep r * 10 below 2^64
+    num >>= 1;
+    den >>= 1;
+  }
+
+  q = num / den;
+  r = num % den;
+  for (i = 0; i < decimals; i++){
+    r *= 10;
+    frac[i] = '0' + r / den;
+    r %= den;
+  }
+  frac[decimals] = '\0';
+  if (r >= den - r){
+    for (i = decimals - 1; i >= 0 && frac[i] == '9'; i--) frac[i] = '0';
+    if (i >= 0)
+      frac[i]++;
+    else
+      q++;
+  }
+  return decimals ? printf("%llu.%s", q, frac) : printf("%llu", q);
+}
 
 int sprintf(char *out, const char *fmt, ...) {
   va_list ap;
@@ -164,7 +574,6 @@ int sprintf(char *out, const char *fmt, ...) {
 }
 
 int snprintf(char *out, size_t n, const char *fmt, ...) {
-  //panic("Not implemented");
   va_list ap;
   int num;
   va_start(ap, fmt);
@@ -174,25 +583,31 @@ int snprintf(char *out, size_t n, const char *fmt, ...) {
 }
 
 int vsprintf(char *out, const char *fmt, va_list ap) {
-  return vsnprintf(out, strlen(fmt), fmt, ap);
+  return vsnprintf(out, (size_t)-1, fmt, ap);
 }
 
 int vsnprintf(char *out, size_t n, const char *fmt, va_list ap) {
-  int len;
-  unsigned long num;
-  int i, j, base;
-  char *str;
+  strbuf_t sb = { .str = out, .left = n };
+  int len = vcbprintf(str_sink, &sb, fmt, ap);
+  if (n) *sb.str = '\0';
+  return len;
+}
+
+int vcbprintf(printf_sink_t sink, void *ctx, const char *fmt, va_list ap) {
+  outbuf_t o = { .sink = sink, .ctx = ctx, .len = 0, .pos = 0 };
+  unsigned long long num;
+  int len, i, base;
   char *s;
 
   int flags;            // Flags to number()
 
   int field_width;      // Width of output field
   int precision;        // Min. # of digits for integers; max number of chars for from string
-  int qualifier;        // 'h', 'l', or 'L' for integer fields
+  int qualifier;        // 'h', 'l', 'L', 'j', 'z' or 'q' (for "ll") for integer fields
 
-  for (j = 0, str = out; *fmt && j < n; fmt++){
+  for (; *fmt; fmt++){
     if (*fmt != '%'){
-      *str++ = *fmt;
+      emit(&o, *fmt);
       continue;
     }
                  
@@ -236,9 +651,13 @@ repeat:
 
     // Get the conversion qualifier
     qualifier = -1;
-    if (*fmt == 'h' || *fmt == 'l' || *fmt == 'L'){
+    if (*fmt == 'h' || *fmt == 'l' || *fmt == 'L' || *fmt == 'j' || *fmt == 'z'){
       qualifier = *fmt;
       fmt++;
+      if (qualifier == 'l' && *fmt == 'l'){
+        qualifier = 'q';
+        fmt++;
+      }
     }
 
     // Default base
@@ -246,18 +665,18 @@ repeat:
 
     switch (*fmt){
       case 'c':
-        if (!(flags & LEFT)) while (--field_width > 0) *str++ = ' ';
-        *str++ = (unsigned char) va_arg(ap, int);
-        while (--field_width > 0) *str++ = ' ';
+        if (!(flags & LEFT)) pad(&o, ' ', field_width - 1);
+        emit(&o, (unsigned char) va_arg(ap, int));
+        if (flags & LEFT) pad(&o, ' ', field_width - 1);
         continue;
 
       case 's':
         s = va_arg(ap, char *);
         if (!s) s = "<NULL>";
         len = strnlen(s, precision);
-        if (!(flags & LEFT)) while (len < field_width--) *str++ = ' ';
-        for (i = 0; i < len; ++i) *str++ = *s++;
-        while (len < field_width--) *str++ = ' ';
+        if (!(flags & LEFT)) pad(&o, ' ', field_width - len);
+        for (i = 0; i < len; ++i) emit(&o, *s++);
+        if (flags & LEFT) pad(&o, ' ', field_width - len);
         continue;
 
       case 'p':
@@ -265,17 +684,21 @@ repeat:
           field_width = 2 * sizeof(void *);
           flags |= ZEROPAD;
         }
-        str = number(str, (unsigned long) va_arg(ap, void *), 16, field_width, precision, flags);
+        number(&o, (uintptr_t) va_arg(ap, void *), 16, field_width, precision, flags);
         continue;
 
       case 'n':
-        if (qualifier == 'l'){
+        if (qualifier == 'q' || qualifier == 'j'){
+          long long *ip = va_arg(ap, long long *);
+          *ip = o.len;
+        }
+        else if (qualifier == 'l'){
           long *ip = va_arg(ap, long *);
-          *ip = (str - out);
+          *ip = o.len;
         }
         else{
           int *ip = va_arg(ap, int *);
-          *ip = (str - out);
+          *ip = o.len;
         }
         continue;
 
@@ -284,11 +707,23 @@ repeat:
 
       case 'a':
         if (qualifier == 'l')
-          str = eaddr(str, va_arg(ap, unsigned char *), field_width, precision, flags);
+          eaddr(&o, va_arg(ap, unsigned char *), field_width, precision, flags);
         else
-          str = iaddr(str, va_arg(ap, unsigned char *), field_width, precision, flags);
+          iaddr(&o, va_arg(ap, unsigned char *), field_width, precision, flags);
         continue;
 
+      case 'E':
+      case 'F':
+        flags |= LARGE;
+
+      case 'e':
+      case 'f':{
+        union { double d; uint64_t bits; } v;
+        v.d = va_arg(ap, double);
+        fnumber(&o, v.bits, *fmt, field_width, precision, flags);
+        continue;
+      }
+
       // Integer number formats - set up the flags and "break"
       case 'o':
         base = 8;
@@ -309,16 +744,28 @@ repeat:
         break;
 
       default:
-        if (*fmt != '%') *str++ = '%';
+        if (*fmt != '%') emit(&o, '%');
         if (*fmt)
-          *str++ = *fmt;
+          emit(&o, *fmt);
         else
           --fmt;
         continue;
     }
 
-    if (qualifier == 'l')
-      num = va_arg(ap, unsigned long);
+    if (qualifier == 'q' || qualifier == 'j')
+      num = va_arg(ap, unsigned long long);
+    else if (qualifier == 'l'){
+      if (flags & SIGN)
+        num = va_arg(ap, long);
+      else
+        num = va_arg(ap, unsigned long);
+    }
+    else if (qualifier == 'z'){
+      if (flags & SIGN)
+        num = va_arg(ap, ptrdiff_t);
+      else
+        num = va_arg(ap, size_t);
+    }
     else if (qualifier == 'h'){
       if (flags & SIGN)
         num = va_arg(ap, int);
@@ -330,9 +777,9 @@ repeat:
     else
       num = va_arg(ap, unsigned int);
 
-    str = number(str, num, base, field_width, precision, flags);
+    number(&o, num, base, field_width, precision, flags);
   }
 
-  *str = '\0';
-  return str - out;
-}
\ No newline at end of file
+  flush_chunk(&o);
+  return o.len;
+}
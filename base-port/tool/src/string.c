@@ -1,22 +1,52 @@
 #include <tool.h>
+
+/* word-at-a-time helpers shared by the str* and mem* routines below */
+typedef uint32_t __attribute__((__may_alias__)) word_t;
+#define WSIZE      sizeof(word_t)
+#define WMASK      (WSIZE - 1)
+#define ALIGNED(p) (((uintptr_t)(p) & WMASK) == 0)
+
+/* Non-zero iff the word holds a zero byte. The lowest flagged byte is always
+ * the first zero byte in memory order (little-endian); flags above it may be
+ * spurious. Zbb's orc.b gives an exact per-byte answer in one instruction. */
+#ifdef __riscv_zbb
+static inline word_t haszero(word_t x) {
+  word_t r;
+  asm ("orc.b %0, %1" : "=r"(r) : "r"(x));
+  return ~r;
+}
+#else
+#define haszero(x) (((x) - 0x01010101u) & ~(x) & 0x80808080u)
+#endif
+#define splat(c)   (0x01010101u * (unsigned char)(c))
+
+/* Order two unequal words by their first differing byte in memory. Byte
+ * swapping puts that byte on top (little-endian), so an unsigned compare
+ * of the swapped words decides it without hunting for the byte. */
+static inline int word_cmp(word_t a, word_t b) {
+  return __builtin_bswap32(a) < __builtin_bswap32(b) ? -1 : 1;
+}
+
 size_t strlen(const char *s) {
-  size_t size = 0;
-  while(*s) {
-    s++;
-    size++;
-  } 
-  return size;
+  const char *p = s;
+  for(; !ALIGNED(p); p++) if(!*p) return p - s;
+  const word_t *w = (const word_t*) p;
+  while(!haszero(*w)) w++;
+  for(p = (const char*) w; *p; p++);
+  return p - s;
 }
+
 size_t strnlen(const char *s, size_t count){
-  const char *sc;
-  for (sc = s; *sc != '\0' && count--; ++sc);
-  return sc - s;
+  const char *p = s;
+  for(; count && !ALIGNED(p); count--, p++) if(!*p) return p - s;
+  const word_t *w = (const word_t*) p;
+  for(; count >= WSIZE && !haszero(*w); count -= WSIZE) w++;
+  for(p = (const char*) w; count && *p; count--) p++;
+  return p - s;
 }
 
 char *strcpy(char *dst, const char *src) {
-  int i;
-  for(i = 0; src[i]; i++) dst[i] = src[i];
-  dst[i] = src[i];
+  memcpy(dst, src, strlen(src) + 1);
   return dst;
 }
 
@@ -27,92 +57,193 @@ char *strncpy(char *dst, const char *src, size_t n) {
 }
 
 char *strcat(char *dst, const char *src) {
-  int i = strlen(dst);
-  for(int j = 0; src[j]; i++, j++) dst[i] = src[j];
-  dst[i] = 0;
+  strcpy(dst + strlen(dst), src);
   return dst;
 }
 
 int strcmp(const char *s1, const char *s2) {
-  int i;
-  for(i = 0; s1[i] && s2[i]; i++){
-    if(s1[i] > s2[i]) return 1;
-    else if(s1[i] < s2[i]) return -1;
+  const unsigned char *p = (const unsigned char*) s1;
+  const unsigned char *q = (const unsigned char*) s2;
+  if((((uintptr_t)p ^ (uintptr_t)q) & WMASK) == 0){
+    for(; !ALIGNED(p); p++, q++) if(*p != *q || !*p) return *p - *q;
+    const word_t *wp = (const word_t*) p;
+    const word_t *wq = (const word_t*) q;
+    while(*wp == *wq && !haszero(*wp)){
+      wp++;
+      wq++;
+    }
+    p = (const unsigned char*) wp;
+    q = (const unsigned char*) wq;
+  }
+  while(*p && *p == *q){
+    p++;
+    q++;
   }
-  if(s1[i]) return 1;
-  else if(s2[i]) return -1;
-  else return 0;
+  return *p - *q;
 }
 
 int strncmp(const char *s1, const char *s2, size_t n) {
-  if(n < 0) return 0;
-  int i;
-  for(i = 0; i < n && s1[i] && s2[i]; i++){
-    if(s1[i] > s2[i]) return 1;
-    else if(s1[i] < s2[i]) return -1;
+  const unsigned char *p = (const unsigned char*) s1;
+  const unsigned char *q = (const unsigned char*) s2;
+  if((((uintptr_t)p ^ (uintptr_t)q) & WMASK) == 0){
+    for(; n && !ALIGNED(p); n--, p++, q++) if(*p != *q || !*p) return *p - *q;
+    const word_t *wp = (const word_t*) p;
+    const word_t *wq = (const word_t*) q;
+    for(; n >= WSIZE && *wp == *wq && !haszero(*wp); n -= WSIZE){
+      wp++;
+      wq++;
+    }
+    p = (const unsigned char*) wp;
+    q = (const unsigned char*) wq;
   }
-  if(i == n) return 0;
-  else if(s1[i]) return 1;
-  else return -1;
+  for(; n; n--, p++, q++) if(*p != *q || !*p) return *p - *q;
+  return 0;
 }
 
 char* strchr(const char *s, int c) {
-  while(*s){
-    if(*s == c) return (char*)s;
-    s++;
+  char ch = (char) c;
+  for(; !ALIGNED(s); s++){
+    if(*s == ch) return (char*)s;
+    if(!*s) return NULL;
+  }
+  word_t cc = splat(ch);
+  const word_t *w = (const word_t*) s;
+  while(!haszero(*w) && !haszero(*w ^ cc)) w++;
+  for(s = (const char*) w;; s++){
+    if(*s == ch) return (char*)s;
+    if(!*s) return NULL;
   }
-  return NULL;
 }
 
 char* strrchr(const char *s, int c) {
-  char *p = NULL;
-  while(*s){
-    if(*s == c) p = (char*)s;
-    s++;
+  char ch = (char) c;
+  const char *last = NULL;
+  for(; !ALIGNED(s); s++){
+    if(*s == ch) last = s;
+    if(!*s) return (char*)last;
+  }
+  word_t cc = splat(ch);
+  const word_t *w = (const word_t*) s, *hit = NULL;
+  for(; !haszero(*w); w++) if(haszero(*w ^ cc)) hit = w;
+  if(hit){
+    for(const char *p = (const char*) hit; p < (const char*)(hit + 1); p++)
+      if(*p == ch) last = p;
+  }
+  for(s = (const char*) w;; s++){
+    if(*s == ch) last = s;
+    if(!*s) return (char*)last;
   }
-  return p;
 }
 
 void *memset(void *s, int c, size_t n) {
-  if(!s || n < 0) return NULL;
   unsigned char *p = (unsigned char*) s;
-  for(int i = 0; i < n; i++) p[i]= (unsigned char) c;
+  if(n >= 2 * WSIZE){
+    word_t w = splat(c);
+    for(; !ALIGNED(p); n--) *p++ = (unsigned char) c;
+    word_t *wp = (word_t*) p;
+    for(; n >= 8 * WSIZE; n -= 8 * WSIZE, wp += 8){
+      wp[0] = w; wp[1] = w; wp[2] = w; wp[3] = w;
+      wp[4] = w; wp[5] = w; wp[6] = w; wp[7] = w;
+    }
+    for(; n >= WSIZE; n -= WSIZE) *wp++ = w;
+    p = (unsigned char*) wp;
+  }
+  while(n--) *p++ = (unsigned char) c;
   return s;
 }
 
-void *memmove(void *dst, const void *src, size_t n) {
-  if(n < 0) return dst;
-  unsigned char *q = (unsigned char*) src;
-  unsigned char *p = (unsigned char*) dst;
-  if(p < q){
-    for(int i = 0; i < n; i++) p[i] = q[i];
+/* forward copy; also safe for overlapping buffers as long as dst < src */
+static void copy_fwd(unsigned char *p, const unsigned char *q, size_t n) {
+  if(n >= 2 * WSIZE){
+    for(; !ALIGNED(p); n--) *p++ = *q++;
+    word_t *wp = (word_t*) p;
+    size_t off = (uintptr_t)q & WMASK;
+    if(off == 0){
+      const word_t *wq = (const word_t*) q;
+      for(; n >= 8 * WSIZE; n -= 8 * WSIZE, wp += 8, wq += 8){
+        word_t w0 = wq[0], w1 = wq[1], w2 = wq[2], w3 = wq[3];
+        word_t w4 = wq[4], w5 = wq[5], w6 = wq[6], w7 = wq[7];
+        wp[0] = w0; wp[1] = w1; wp[2] = w2; wp[3] = w3;
+        wp[4] = w4; wp[5] = w5; wp[6] = w6; wp[7] = w7;
+      }
+      for(; n >= WSIZE; n -= WSIZE) *wp++ = *wq++;
+      q = (const unsigned char*) wq;
+    }
+    else {
+      /* src and dst are mutually misaligned: read aligned source words and
+       * merge neighbours with shifts (little-endian). Every word read holds
+       * at least one byte that belongs to the source buffer. */
+      const word_t *wq = (const word_t*)(q - off);
+      unsigned rs = off * 8, ls = WSIZE * 8 - rs;
+      word_t w0 = *wq++;
+      for(; n >= 4 * WSIZE; n -= 4 * WSIZE, wp += 4, wq += 4){
+        word_t w1 = wq[0], w2 = wq[1], w3 = wq[2], w4 = wq[3];
+        wp[0] = (w0 >> rs) | (w1 << ls);
+        wp[1] = (w1 >> rs) | (w2 << ls);
+        wp[2] = (w2 >> rs) | (w3 << ls);
+        wp[3] = (w3 >> rs) | (w4 << ls);
+        w0 = w4;
+      }
+      for(; n >= WSIZE; n -= WSIZE){
+        word_t w1 = *wq++;
+        *wp++ = (w0 >> rs) | (w1 << ls);
+        w0 = w1;
+      }
+      q = (const unsigned char*) wq - WSIZE + off;
+    }
+    p = (unsigned char*) wp;
   }
-  else {
-    while(n--){
-      p[n] = q[n];
+  while(n--) *p++ = *q++;
+}
+
+/* backward copy for overlapping buffers with dst > src */
+static void copy_bwd(unsigned char *p, const unsigned char *q, size_t n) {
+  p += n;
+  q += n;
+  if(n >= 2 * WSIZE && (((uintptr_t)p ^ (uintptr_t)q) & WMASK) == 0){
+    for(; !ALIGNED(p); n--) *--p = *--q;
+    word_t *wp = (word_t*) p;
+    const word_t *wq = (const word_t*) q;
+    for(; n >= 4 * WSIZE; n -= 4 * WSIZE){
+      wp -= 4; wq -= 4;
+      word_t w3 = wq[3], w2 = wq[2], w1 = wq[1], w0 = wq[0];
+      wp[3] = w3; wp[2] = w2; wp[1] = w1; wp[0] = w0;
     }
+    for(; n >= WSIZE; n -= WSIZE) *--wp = *--wq;
+    p = (unsigned char*) wp;
+    q = (const unsigned char*) wq;
   }
+  while(n--) *--p = *--q;
+}
+
+void *memmove(void *dst, const void *src, size_t n) {
+  unsigned char *p = (unsigned char*) dst;
+  const unsigned char *q = (const unsigned char*) src;
+  if(p == q || n == 0) return dst;
+  if(p < q || p >= q + n) copy_fwd(p, q, n);
+  else copy_bwd(p, q, n);
   return dst;
 }
 
 void *memcpy(void *out, const void *in, size_t n) {
-  if(n < 0) return out;
-  unsigned char *q = (unsigned char*) in;
-  unsigned char *p = (unsigned char*) out;
-  for(int i = 0; i < n; i++) p[i] = q[i];
+  copy_fwd((unsigned char*) out, (const unsigned char*) in, n);
   return out;
 }
 
 int memcmp(const void *s1, const void *s2, size_t n) {
-  if(n < 0) return 0;
-  int i;
-  unsigned char *p = (unsigned char*)s1;
-  unsigned char *q = (unsigned char*)s2;
-  for(i = 0; i < n && p[i] && q[i]; i++){
-    if(p[i] > q[i]) return 1;
-    else if(p[i] < q[i]) return -1;
+  const unsigned char *p = (const unsigned char*) s1;
+  const unsigned char *q = (const unsigned char*) s2;
+  if(n >= 2 * WSIZE && (((uintptr_t)p ^ (uintptr_t)q) & WMASK) == 0){
+    for(; !ALIGNED(p); n--, p++, q++) if(*p != *q) return *p - *q;
+    const word_t *wp = (const word_t*) p;
+    const word_t *wq = (const word_t*) q;
+    for(; n >= 2 * WSIZE; n -= 2 * WSIZE, wp += 2, wq += 2){
+      if(wp[0] != wq[0]) return word_cmp(wp[0], wq[0]);
+      if(wp[1] != wq[1]) return word_cmp(wp[1], wq[1]);
+    }
+    p = (const unsigned char*) wp;
+    q = (const unsigned char*) wq;
   }
-  if(i == n) return 0;
-  else if(p[i]) return 1;
-  else return -1;
+  for(; n; n--, p++, q++) if(*p != *q) return *p - *q;
+  return 0;
 }
\ No newline at end of file
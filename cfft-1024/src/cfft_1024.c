@@ -1,5 +1,7 @@
 // ...existing code...
 #include "cfft.h"
+#include <tool.h>
+#include <perf.h>
 // #include <stdio.h>
 #include <stdint.h>
 #define FFT_N 1024
@@ -53,7 +55,7 @@ static void bit_reverse_reorder_generic(complex_t* data) {
 }
 
 // 扭结因子表（W_N^k, k=0..N/2-1），用递推生成，避免三角函数
-static complex_t twiddle_factors[FFT_N / 2];
+static complex_t twiddle_factors[FFT_N / 2] __dtcm_bss;
 static int twiddles_initialized = 0;
 // 生成 W_N^k 表：w_{k+1} = w_k * W1，W1 ≈ cos(2π/N) - j sin(2π/N)
 static void init_twiddles(void) {
@@ -72,6 +74,23 @@ static void init_twiddles(void) {
     twiddles_initialized = 1;
 }
 
+// 一级蝶形中的第 begin..end-1 个蝶形（每级共 N/2 个），供 parallel_for 分给各个 hart
+struct fft_stage {
+    complex_t *data;
+    int halfsize, step;
+};
+static void fft_butterflies(int begin, int end, void *ctx) {
+    const struct fft_stage *s = ctx;
+    for (int b = begin; b < end; b++) {
+        int j = b & (s->halfsize - 1);  // 段内位置
+        int i = 2 * b - j;              // = 段起点 + j
+        complex_t t, u = s->data[i];
+        complex_multiply(s->data[i + s->halfsize], twiddle_factors[j * s->step], &t);
+        complex_add(u, t, &s->data[i]);
+        complex_subtract(u, t, &s->data[i + s->halfsize]);
+    }
+}
+
 void fft_1024_point(const complex_t input[FFT_N], complex_t output[FFT_N]) {
     init_twiddles();
 
@@ -86,21 +105,9 @@ void fft_1024_point(const complex_t input[FFT_N], complex_t output[FFT_N]) {
     while (m <= FFT_N) {
         int halfsize = m >> 1;//也是每段的stride，即每段内相隔多少个元素进行蝶形运算
 
-        for (int block = 0; block < FFT_N; block += m) {
-            int k = 0;
-            for (int j = 0; j < halfsize; j++) {
-                complex_t t, u, v;
-                complex_multiply(output[block + j + halfsize], twiddle_factors[k], &t);
-
-                u = output[block + j];
-                v = t;
-
-                complex_add(u, v, &output[block + j]);
-                complex_subtract(u, v, &output[block + j + halfsize]);
-
-                k += step; // k = j * (N/m)
-            }
-        }
+        // 同一级内的蝶形互不依赖，按 hart 切分；级与级之间由 parallel_for 的 join 隔开
+        struct fft_stage stage = { output, halfsize, step };
+        parallel_for(0, FFT_N / 2, FFT_N / 16, fft_butterflies, &stage);
         //下一级，蝶形长度翻倍，旋转因子步长减半
         m <<= 1;
         step >>= 1;
@@ -109,7 +116,8 @@ void fft_1024_point(const complex_t input[FFT_N], complex_t output[FFT_N]) {
 
 // 1024 点 IFFT：共轭→FFT→共轭并除以 N
 void ifft_1024_point(const complex_t input[FFT_N], complex_t output[FFT_N]) {
-    complex_t temp[FFT_N];
+    arena_mark_t mark = arena_mark();
+    complex_t *temp = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
 
     // 共轭
     for (int i = 0; i < FFT_N; i++) {
@@ -125,6 +133,7 @@ void ifft_1024_point(const complex_t input[FFT_N], complex_t output[FFT_N]) {
         output[i].real = (int32_t)( output[i].real >> LOG2_FFT_N);
         output[i].imag = (int32_t)((-output[i].imag) >> LOG2_FFT_N);
     }
+    arena_reset(mark);
 }
 
 // 幅度平方
@@ -168,10 +177,12 @@ int test_impulse_1024() {
         test_input[i].imag = 0;
     }
     
-    complex_t fft_output[FFT_N];
+    complex_t *fft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
     
     
+    ROI_BEGIN();
     fft_1024_point(test_input, fft_output);
+    ROI_END();
     
     // 
     uint32_t reference_mag = magnitude_squared(fft_output[0]);
@@ -194,9 +205,11 @@ int test_dc_1024() {
         test_input[i].imag = 0;
     }
     
-    complex_t fft_output[FFT_N];
+    complex_t *fft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
     
+    ROI_BEGIN();
     fft_1024_point(test_input, fft_output);
+    ROI_END();
     
     // Check DC component (should be FFT_N * 32767)
     uint32_t dc_mag = magnitude_squared(fft_output[0]);
@@ -253,10 +266,12 @@ int test_single_frequency_1024() {
     test_input[14 + 16 * k].real = 23170; test_input[14 + 16 * k].imag = 23170;  // k=14: 0.7071 + 0.7071j
     test_input[15 + 16 * k].real = 30273; test_input[15 + 16 * k].imag = 12539;  // k=15: 0.9239 + 0.3827j
     }
-    complex_t fft_output[FFT_N];
+    complex_t *fft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
     
     // Perform fixed-point FFT
+    ROI_BEGIN();
     fft_1024_point(test_input, fft_output);
+    ROI_END();
     
     // Check that energy is concentrated at bin 1
     uint32_t bin1_mag = magnitude_squared(fft_output[64]);
@@ -284,12 +299,14 @@ int test_ifft_correctness_1024() {
         original[i].imag = 0;
     }
 
-complex_t fft_output[FFT_N];
-complex_t ifft_output[FFT_N];
+    complex_t *fft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
+    complex_t *ifft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
     
     // Perform FFT then IFFT
+    ROI_BEGIN();
     fft_1024_point(original, fft_output);
     ifft_1024_point(fft_output, ifft_output);
+    ROI_END();
     
     // Check if we recovered the original signal
     int32_t tolerance = 1000;  // Allow some error due to fixed-point rounding
@@ -314,19 +331,42 @@ int test_fft_time(){
         test_input[i].real = 32767;
         test_input[i].imag = 0;
     }    
-    complex_t fft_output[FFT_N];
+    complex_t *fft_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
+    ROI_BEGIN();
     fft_1024_point(test_input, fft_output);
+    ROI_END();
+
+    // 随 hart 数增加的加速比，结果须与单 hart 一致
+    if (num_harts() > 1) {
+        complex_t *par_output = arena_alloc(FFT_N * sizeof(complex_t), ARENA_ALIGN);
+        uint64_t t_serial = 0;
+        for (int n = 1; n <= num_harts(); n++) {
+            parallel_set_harts(n);
+            uint64_t t0 = read_cycle64();
+            fft_1024_point(test_input, par_output);
+            uint64_t t = read_cycle64() - t0;
+            if (n == 1) t_serial = t;
+            if (memcmp(par_output, fft_output, FFT_N * sizeof(complex_t)) != 0) return -1;
+            printf("fft_1024 %d harts: %llu cycles, speedup ", n, t);
+            print_ratio(t_serial, t, 2);
+            putch('\n');
+        }
+        parallel_set_harts(0);
+    }
     return 0;
 }
 int test_fft_1024() {
     int test_results[4];
     for (int i=0; i<1; i++) {
+    // every test takes its output buffers from the arena; reclaim them per pass
+    arena_mark_t mark = arena_mark();
     test_results[0] = test_impulse_1024();
     test_results[1] = test_dc_1024();
     test_results[2] = test_fft_time();
     // test_results[2] = test_single_frequency_1024();
     test_results[3] = test_ifft_correctness_1024();
     bench_sink += (test_results[0] + test_results[1] + test_results[2]);
+    arena_reset(mark);
     }
     if (bench_sink == -123456789) { // impossible path; prevents clever DCE
         // printf("%d\n", bench_sink);
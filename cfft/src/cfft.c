@@ -16,6 +16,7 @@
 // Force single register operations to avoid LDM/STM instructions
 
 #include "cfft.h"
+#include <perf.h>
 
 // Compiler attributes to control instruction generation
 #define AVOID_LDMSTM __attribute__((optimize("-fno-tree-loop-distribute-patterns")))
@@ -251,7 +252,9 @@ int test_impulse() {
     complex_t fft_output[16];
     
     // ->BLOCK6-22
+    ROI_BEGIN();
     fft_16_point(test_input, fft_output);
+    ROI_END();
     
     // Verify results: all bins should have similar magnitude
     uint32_t reference_mag = magnitude_squared(fft_output[0]);
@@ -285,7 +288,9 @@ int test_dc() {
     complex_t fft_output[16];
     
     // Perform fixed-point FFT
+    ROI_BEGIN();
     fft_16_point(test_input, fft_output);
+    ROI_END();
     
     // Check DC component (should be 16 * 32767)
     uint32_t dc_mag = magnitude_squared(fft_output[0]);
@@ -336,7 +341,9 @@ int test_single_frequency() {
     complex_t fft_output[16];
     
     // Perform fixed-point FFT
+    ROI_BEGIN();
     fft_16_point(test_input, fft_output);
+    ROI_END();
     
     // Check that energy is concentrated at bin 1
     uint32_t bin1_mag = magnitude_squared(fft_output[1]);
@@ -371,8 +378,10 @@ int test_ifft_correctness() {
     complex_t ifft_output[16];
     
     // Perform FFT then IFFT
+    ROI_BEGIN();
     fft_16_point(original, fft_output);
     ifft_16_point(fft_output, ifft_output);
+    ROI_END();
     
     // Check if we recovered the original signal
     int32_t tolerance = 1000;  // Allow some error due to fixed-point rounding
@@ -8,9 +8,10 @@
 
 #include <base.h>
 #include <tool.h>
+#include <perf.h>
 
 #define ITERATIONS 30
-#define MEM_METHOD MEM_STATIC
+#define MEM_METHOD MEM_MALLOC
 
 /************************/
 /* Data types and settings */
@@ -128,6 +129,14 @@ typedef size_t ee_size_t;
 	It is valid to have a different implementation of <core_start_parallel> and <core_end_parallel> in <core_portme.c>,
 	to fit a particular architecture.
 */
+#if !defined(MULTITHREAD) && defined(NR_HARTS) && NR_HARTS > 1
+/* one context per hart, launched through the libtool fork-join runtime */
+#define MULTITHREAD NR_HARTS
+#define PARALLEL_METHOD "harts"
+#define USE_PTHREAD 0
+#define USE_FORK 0
+#define USE_SOCKET 0
+#endif
 #ifndef MULTITHREAD
 #define MULTITHREAD 1
 #define USE_PTHREAD 0
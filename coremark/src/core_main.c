@@ -218,6 +218,7 @@ MAIN_RETURN_TYPE main(int argc, char *argv[]) {
 	}
 	/* perform actual benchmark */
 	// start_time();
+	ROI_BEGIN();
 #if (MULTITHREAD>1)
 	if (default_num_contexts>MULTITHREAD) {
 		default_num_contexts=MULTITHREAD;
@@ -233,6 +234,7 @@ MAIN_RETURN_TYPE main(int argc, char *argv[]) {
 #else
 	iterate(&results[0]);
 #endif
+	ROI_END();
 	// stop_time();
 	total_time=get_time();
 	/* get a function of the input to report */
@@ -82,7 +82,7 @@ secs_ret time_in_secs(CORE_TICKS ticks) {
   return ticks;
 }
 
-ee_u32 default_num_contexts=1;
+ee_u32 default_num_contexts=MULTITHREAD;
 
 /* Function : portable_init
 	Target specific initialization code
@@ -106,4 +106,50 @@ void portable_fini(core_portable *p)
 	p->portable_id=0;
 }
 
+/* Function : portable_malloc
+	Data blocks come from the libtool arena, cache-line aligned and off the stack.
+*/
+void *portable_malloc(ee_size_t size)
+{
+	return arena_alloc(size, ARENA_ALIGN);
+}
+/* Function : portable_free
+	Arena memory is reclaimed wholesale; nothing to do per block.
+*/
+void portable_free(void *p)
+{
+}
+
+#if (MULTITHREAD>1)
+/* Function : core_start_parallel
+	Contexts are only queued here; the first core_stop_parallel runs them
+	all at once, context i on hart i, and joins.
+*/
+static core_results *contexts[MULTITHREAD];
+static int nr_contexts;
+
+static void run_context(int hart, void *unused)
+{
+	if (hart < nr_contexts)
+		iterate(contexts[hart]);
+}
+
+ee_u8 core_start_parallel(core_results *res)
+{
+	contexts[nr_contexts++]=res;
+	return 0;
+}
+/* Function : core_stop_parallel
+	Runs the queued contexts on the first call; later calls have nothing to wait for.
+*/
+ee_u8 core_stop_parallel(core_results *res)
+{
+	if (nr_contexts>0) {
+		run_on_all_harts(run_context, NULL);
+		nr_contexts=0;
+	}
+	return 0;
+}
+#endif
+
 
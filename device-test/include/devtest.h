@@ -2,5 +2,6 @@
 #define DEVTEST_H__
 #include <base.h>
 #include <tool.h>
+#include <perf.h>
 
 #endif
\ No newline at end of file
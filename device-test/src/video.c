@@ -16,6 +16,31 @@ static int used[N][N];
 
 static uint32_t color_buf[32 * 32];
 
+#ifdef VIDEO_FRAME_UPLOAD
+// build the whole frame in memory and upload it with a single GPU_MEMCPY
+void redraw()
+{
+    static uint32_t *frame;
+    int width = io_read(DEV_GPU_CONFIG).width;
+    int height = io_read(DEV_GPU_CONFIG).height;
+    int w = width / N, h = height / N;
+    if (!frame)
+        frame = malloc(width * height * sizeof(uint32_t));
+
+    for (int py = 0; py < height; py++)
+    {
+        uint32_t *row = frame + py * width;
+        int y = py / h < N ? py / h : N - 1;
+        for (int x = 0, px = 0; x < N; x++)
+            for (int k = 0; k < w; k++)
+                row[px++] = canvas[y][x];
+        for (int px = N * w; px < width; px++)
+            row[px] = canvas[y][N - 1];
+    }
+    io_write(DEV_GPU_MEMCPY, 0, frame, width * height * sizeof(uint32_t));
+    io_write(DEV_GPU_FBDRAW, 0, 0, NULL, 0, 0, true);
+}
+#else
 void redraw()
 {
     int w = io_read(DEV_GPU_CONFIG).width / N;
@@ -37,6 +62,7 @@ void redraw()
     }
     io_write(DEV_GPU_FBDRAW, 0, 0, NULL, 0, 0, true);
 }
+#endif
 
 static uint32_t p(int tsc)
 {
@@ -85,6 +111,7 @@ void video_test()
     unsigned long last = 0;
     unsigned long fps_last = 0;
     int fps = 0;
+    uint64_t redraw_cycles = 0;
 
     while (1)
     {
@@ -92,16 +119,20 @@ void video_test()
         if (upt - last > 1000 / FPS)
         {
             update();
+            uint64_t t0 = read_cycle64();
             redraw();
+            redraw_cycles += read_cycle64() - t0;
             last = upt;
             fps++;
         }
         if (upt - fps_last > 1000)
         {
-            // display fps every 1s
-            printf("%d: FPS = %d\n", upt, fps);
+            // display fps and the average cost of one redraw every 1s
+            printf("%d: FPS = %d, redraw = %d cycles/frame\n", upt, fps,
+                   fps ? (int)(redraw_cycles / fps) : 0);
             fps_last = upt;
             fps = 0;
+            redraw_cycles = 0;
         }
     }
 }
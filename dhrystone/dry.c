@@ -355,6 +355,7 @@
 // #include <klib-macros.h>
 #include <tool.h>
 #include <base.h>
+#include <perf.h>
 
 //static uint32_t uptime_ms() { return io_read(DEV_TIMER_UPTIME).us / 1000; }
 // #define Start_Timer() Begin_Time = uptime_ms()
@@ -452,13 +453,9 @@ float           Microseconds,
 
 /* end of variables for time measurement */
 
-static char memory[1024];
-static char *free_mem = &memory[0];
-
 static char* myalloc(size_t size) {
-  while ((unsigned long)free_mem % 4 != 0) free_mem ++;
-  char *ret = free_mem;
-  free_mem += size;
+  char *ret = malloc(size);
+  assert(ret);
   return ret;
 }
 
@@ -785,6 +782,7 @@ int main ()
     /***************/
 
     // Start_Timer();
+    ROI_BEGIN();
     Int_3_Loc = 0;
     for (Run_Index = 1; Run_Index <= Number_Of_Runs; ++Run_Index)
     {
@@ -838,6 +836,7 @@ int main ()
     /**************/
 
     // Stop_Timer();
+    ROI_END();
 
     User_Time = 1;//End_Time - Begin_Time;
 
@@ -22,6 +22,19 @@ int main() {
 	check(strcmp( strcat(strcpy(str, str1), s[3]), s[4]) == 0);
 
 	check(memcmp(memset(str, '#', 5), s[5], 5) == 0);
+	check(memcmp("ab\0cd", "ab\0ce", 5) < 0);
+	check(memcmp(s[0], s[1], 38) < 0);
+	check(memcmp(s[1], s[0], 38) > 0);
+
+	check(strlen(s[0] + 1) == 37);
+	check(strnlen(s[4], 5) == 5);
+	check(strncmp(s[0], s[1], 37) == 0);
+	check(strncmp(s[0] + 1, s[1] + 1, 40) < 0);
+	check(strncmp(str1, "Hello", 20) == 0);
+	check(strchr(s[4], 'W') == s[4] + 7);
+	check(strchr(s[4], 'z') == NULL);
+	check(strrchr(s[4] + 1, 'o') == s[4] + 8);
+	check(strrchr(s[1], 'a') == s[1] + 36);
 
 	return 0;
 }
@@ -0,0 +1,27 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <base.h>
+#include <tool.h>
+#include <perf.h>
+
+__attribute__((noinline))
+void check(int cond) {
+  if (!cond) halt(1);
+}
+
+static inline uint32_t bench_cycles() {
+  return read_cycle();
+}
+
+// keep the optimizer from discarding results that are only used for timing
+#define bench_sink(p) asm volatile("" : : "r"(p) : "memory")
+
+// "<name>: <cycles> cycles, <instret> instrs, IPC <ipc>"
+static inline void bench_report(const char *name, perf_snapshot d) {
+  printf("%s: %llu cycles, %llu instrs, IPC ", name, d.cycles, d.instret);
+  print_ratio(d.instret, d.cycles, 3);
+  putch('\n');
+}
+
+#endif
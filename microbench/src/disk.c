@@ -0,0 +1,77 @@
+#include "bench.h"
+
+// ramdisk read throughput: read-then-process one block at a time, against
+// disk_stream double buffering where block N+1 is read while N is processed
+
+#define BLOCK  4096
+#define BLOCKS 16
+#define TOTAL  (BLOCK * BLOCKS)
+
+static uint8_t pattern[BLOCK];
+static uint8_t buf[2][BLOCK];
+
+// the per-block "kernel": a Fletcher-style checksum
+static uint32_t process(const uint8_t *p, uint32_t len, uint32_t sum) {
+  uint32_t a = sum & 0xffff, b = sum >> 16;
+  for (uint32_t i = 0; i < len; i++) {
+    a = (a + p[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
+
+static uint32_t read_sync(perf_snapshot *d) {
+  uint32_t sum = 1;
+  perf_snapshot t0 = perf_read();
+  for (int i = 0; i < BLOCKS; i++) {
+    ramdisk_read(buf[0], i * BLOCK, BLOCK);
+    sum = process(buf[0], BLOCK, sum);
+  }
+  *d = perf_delta(t0, perf_read());
+  return sum;
+}
+
+static uint32_t read_overlapped(perf_snapshot *d) {
+  uint32_t sum = 1, len;
+  disk_stream_t s;
+  perf_snapshot t0 = perf_read();
+  disk_stream_open(&s, buf[0], buf[1], BLOCK, 0, TOTAL);
+  for (uint8_t *p; (p = disk_stream_next(&s, &len)) != NULL; )
+    sum = process(p, len, sum);
+  *d = perf_delta(t0, perf_read());
+  return sum;
+}
+
+int main() {
+  for (int i = 0; i < BLOCK; i++) pattern[i] = i * 7 + 3;
+  for (int i = 0; i < BLOCKS; i++) {
+    pattern[0] = i;
+    ramdisk_write(pattern, i * BLOCK, BLOCK);
+  }
+
+  // the queue must complete requests in order and hand back what was written
+  disk_req_t req[3];
+  for (int i = 0; i < 3; i++) {
+    req[i] = (disk_req_t) { .buf = buf[i & 1], .offset = (i + 1) * BLOCK, .len = 16, .cmd = DISK_READ };
+    disk_submit(&req[i]);
+  }
+  disk_wait(&req[2]);
+  check(req[0].state == DISK_REQ_DONE && req[1].state == DISK_REQ_DONE);
+  check(buf[0][0] == 3 && buf[1][0] == 2 && buf[1][1] == 10);
+
+  perf_snapshot sync, overlap;
+  uint32_t s0 = read_sync(&sync);
+  uint32_t s1 = read_overlapped(&overlap);
+  check(s0 == s1);
+
+  bench_report("sync read      ", sync);
+  bench_report("overlapped read", overlap);
+  printf("bytes/kcycle: sync ");
+  print_ratio(TOTAL * 1000ull, sync.cycles, 1);
+  printf(", overlapped ");
+  print_ratio(TOTAL * 1000ull, overlap.cycles, 1);
+  printf(", speedup ");
+  print_ratio(sync.cycles, overlap.cycles, 2);
+  putch('\n');
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include "bench.h"
+#include <sync.h>
+
+// cycles per spin_lock/spin_unlock pair on a shared counter as the number of
+// contending harts grows (build with NR_HARTS=<n> for more than one hart)
+
+#define ITERS 256
+
+static spinlock_t lock = SPINLOCK_INIT;
+static barrier_t done;
+static atomic_counter_t hits;
+static volatile uint32_t shared;
+static volatile int active;
+
+static void worker(int id) {
+  if (id < active) {
+    for (int i = 0; i < ITERS; i++) {
+      spin_lock(&lock);
+      shared = shared + 1;
+      spin_unlock(&lock);
+      counter_fetch_add(&hits, 1);
+    }
+  }
+  barrier_wait(&done, num_harts());
+}
+
+int main() {
+  int n = num_harts();
+  check(n <= SYNC_MAX_HARTS);
+
+  // a ring round trip on one hart
+  static uintptr_t storage[4];
+  spsc_ring_t ring = SPSC_RING_INIT(storage);
+  uintptr_t v;
+  for (int i = 0; i < 4; i++) check(spsc_push(&ring, i));
+  check(!spsc_push(&ring, 4));
+  for (int i = 0; i < 4; i++) check(spsc_pop(&ring, &v) && v == i);
+  check(!spsc_pop(&ring, &v));
+
+  printf("spinlock cycles per acquire+release (%s)\n", SYNC_VARIANT);
+  printf("%5s %9s\n", "harts", "cycles");
+  for (int a = 1; a <= n; a++) {
+    active = a;
+    shared = 0;
+    uint32_t base = counter_read(&hits);
+    sync_fence();
+    uint32_t t0 = bench_cycles();
+    harts_release(worker);
+    worker(0);
+    uint32_t t = bench_cycles() - t0;
+    check(shared == a * ITERS);
+    check(counter_read(&hits) - base == a * ITERS);
+    printf("%5d %9d\n", a, t / (a * ITERS));
+  }
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include "bench.h"
+
+// cycles per malloc/free of the TLSF heap: fixed-size LIFO pairs, then a
+// random-size churn over a pool of live blocks, with fragmentation and
+// high-water statistics at the end
+
+#define REPS   64
+#define SLOTS  256
+#define ROUNDS 4096
+
+static const size_t sizes[] = {8, 24, 100, 1000, 8192};
+
+static void *slot[SLOTS];
+static uint8_t tag[SLOTS];
+
+static uint32_t seed = 1;
+static uint32_t rnd() {
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 8;
+}
+
+static void print_stats(const char *when) {
+  malloc_stats_t st;
+  malloc_stats(&st);
+  printf("%s: in use %d, peak %d, free %d in %d blocks, largest %d, fragmentation ",
+      when, st.in_use, st.peak, st.free_bytes, st.free_blocks, st.largest_free);
+  print_ratio(st.free_bytes - st.largest_free, st.free_bytes ? st.free_bytes : 1, 3);
+  printf("\n");
+}
+
+int main() {
+  printf("%6s %8s %8s\n", "size", "malloc", "free");
+  for (int i = 0; i < LENGTH(sizes); i++) {
+    uint32_t t_alloc = 0, t_free = 0;
+    for (int r = 0; r < REPS; r++) {
+      uint32_t t0 = bench_cycles();
+      void *p = malloc(sizes[i]);
+      uint32_t t1 = bench_cycles();
+      bench_sink(p);
+      free(p);
+      uint32_t t2 = bench_cycles();
+      check(p != NULL && ((uintptr_t)p & 7) == 0);
+      t_alloc += t1 - t0;
+      t_free += t2 - t1;
+    }
+    printf("%6d %8d %8d\n", sizes[i], t_alloc / REPS, t_free / REPS);
+  }
+
+  // churn: each round frees or allocates a random slot, sizes 1..2048
+  // skewed towards small; every live block is filled and re-verified
+  uint32_t t_alloc = 0, t_free = 0, n_alloc = 0, n_free = 0;
+  for (int r = 0; r < ROUNDS; r++) {
+    int i = rnd() % SLOTS;
+    if (slot[i]) {
+      uint8_t *p = slot[i];
+      check(p[0] == tag[i]);
+      uint32_t t0 = bench_cycles();
+      free(p);
+      t_free += bench_cycles() - t0;
+      n_free++;
+      slot[i] = NULL;
+    } else {
+      size_t n = (rnd() & 3) ? rnd() % 128 + 1 : rnd() % 2048 + 1;
+      uint32_t t0 = bench_cycles();
+      uint8_t *p = malloc(n);
+      t_alloc += bench_cycles() - t0;
+      n_alloc++;
+      check(p != NULL);
+      tag[i] = rnd();
+      memset(p, tag[i], n);
+      slot[i] = p;
+    }
+  }
+  printf("churn: %d cycles/malloc, %d cycles/free over %d/%d calls\n",
+      t_alloc / n_alloc, t_free / n_free, n_alloc, n_free);
+  print_stats("churn");
+
+  // realloc, aligned_alloc and calloc, then tear everything down
+  void *p = malloc(16);
+  for (size_t n = 32; n <= 4096; n <<= 1) {
+    p = realloc(p, n);
+    check(p != NULL);
+  }
+  free(p);
+  for (int a = 16; a <= 4096; a <<= 1) {
+    void *q = aligned_alloc(a, 40);
+    check(q != NULL && ((uintptr_t)q & (a - 1)) == 0);
+    free(q);
+  }
+  uint32_t *z = calloc(64, sizeof(uint32_t));
+  for (int i = 0; i < 64; i++) check(z[i] == 0);
+  free(z);
+  for (int i = 0; i < SLOTS; i++) free(slot[i]);
+
+  malloc_stats_t st;
+  malloc_stats(&st);
+  check(st.in_use == 0 && st.free_blocks == 1);
+  print_stats("final");
+
+  // the bump arena for comparison, carved from the heap on first use;
+  // reset hands the same memory back
+  arena_mark_t mark = arena_mark();
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(arena_alloc(24, 8));
+  uint32_t t_arena = (bench_cycles() - t0) / REPS;
+  arena_reset(mark);
+  void *a0 = arena_alloc(4096, ARENA_ALIGN);
+  arena_reset(mark);
+  check(arena_alloc(4096, ARENA_ALIGN) == a0 && ((uintptr_t)a0 & (ARENA_ALIGN - 1)) == 0);
+  arena_reset(mark);
+  printf("arena: %d cycles/alloc\n", t_arena);
+  return 0;
+}
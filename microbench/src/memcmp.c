@@ -0,0 +1,75 @@
+#include "bench.h"
+
+// memcmp on binary data: results checked against a byte loop, then cycles
+// over sizes for equal buffers and a difference in the last byte
+
+#define MAX_SIZE 2048
+#define REPS     8
+
+static const int sizes[] = {3, 8, 31, 64, 256, 1024, MAX_SIZE};
+
+static uint8_t a_buf[MAX_SIZE + 8] __attribute__((aligned(8)));
+static uint8_t b_buf[MAX_SIZE + 8] __attribute__((aligned(8)));
+
+static int sign(int x) {
+  return (x > 0) - (x < 0);
+}
+
+static int ref_memcmp(const uint8_t *p, const uint8_t *q, int n) {
+  for (int i = 0; i < n; i++)
+    if (p[i] != q[i]) return p[i] - q[i];
+  return 0;
+}
+
+// every third byte is zero so a strcmp-style early exit would be caught
+static void fill(uint8_t *p, int n) {
+  for (int i = 0; i < n; i++) p[i] = i % 3 ? (uint8_t)(i * 13 + 1) : 0;
+}
+
+static uint32_t time_memcmp(const uint8_t *p, const uint8_t *q, int n) {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(memcmp(p, q, n));
+  return (bench_cycles() - t0) / REPS;
+}
+
+int main() {
+  fill(a_buf, sizeof(a_buf));
+  fill(b_buf, sizeof(b_buf));
+
+  // a single differing byte at every position and offset, in both directions
+  for (int off = 0; off < 4; off++) {
+    for (int n = 0; n <= 40; n++) {
+      check(memcmp(a_buf + off, b_buf + off, n) == 0);
+      for (int i = 0; i < n; i++) {
+        uint8_t save = b_buf[off + i];
+        b_buf[off + i] = save + 0x81;
+        int want = sign(ref_memcmp(a_buf + off, b_buf + off, n));
+        check(sign(memcmp(a_buf + off, b_buf + off, n)) == want);
+        check(sign(memcmp(b_buf + off, a_buf + off, n)) == -want);
+        b_buf[off + i] = save;
+      }
+    }
+  }
+  // mutually misaligned buffers take the byte loop
+  for (int n = 0; n < 64; n++) {
+    memcpy(b_buf + 1, a_buf, n);
+    check(memcmp(a_buf, b_buf + 1, n) == 0);
+  }
+  fill(b_buf, sizeof(b_buf));
+
+  printf("memcmp cycles per call\n");
+  printf("%5s %7s %7s %7s\n", "size", "equal", "last", "bytes");
+  for (int i = 0; i < LENGTH(sizes); i++) {
+    int n = sizes[i];
+    uint32_t t_eq = time_memcmp(a_buf, b_buf, n);
+    b_buf[n - 1] ^= 0x80;
+    check(sign(memcmp(a_buf, b_buf, n)) == sign(ref_memcmp(a_buf, b_buf, n)));
+    uint32_t t_last = time_memcmp(a_buf, b_buf, n);
+    b_buf[n - 1] ^= 0x80;
+    uint32_t t0 = bench_cycles();
+    for (int r = 0; r < REPS; r++) bench_sink(ref_memcmp(a_buf, b_buf, n));
+    uint32_t t_ref = (bench_cycles() - t0) / REPS;
+    printf("%5d %7d %7d %7d\n", n, t_eq, t_last, t_ref);
+  }
+  return 0;
+}
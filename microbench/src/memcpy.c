@@ -0,0 +1,89 @@
+#include "bench.h"
+
+// cycle sweep of memcpy/memmove/memset over sizes and (src, dst) alignments
+
+#define MAX_SIZE 2048
+#define REPS     8
+
+static const int sizes[] = {4, 16, 64, 256, 1024, MAX_SIZE};
+
+static uint8_t src_buf[MAX_SIZE + 8] __attribute__((aligned(8)));
+static uint8_t dst_buf[MAX_SIZE + 8] __attribute__((aligned(8)));
+
+static void fill(uint8_t *p, int n, int seed) {
+  for (int i = 0; i < n; i++) p[i] = (uint8_t)(i * 7 + seed);
+}
+
+static void verify_copy(const uint8_t *d, const uint8_t *s, int n) {
+  for (int i = 0; i < n; i++) check(d[i] == s[i]);
+}
+
+static uint32_t time_memcpy(uint8_t *d, const uint8_t *s, int n) {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) {
+    memcpy(d, s, n);
+    bench_sink(d);
+  }
+  return (bench_cycles() - t0) / REPS;
+}
+
+static uint32_t time_memmove(uint8_t *d, const uint8_t *s, int n) {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) {
+    memmove(d, s, n);
+    bench_sink(d);
+  }
+  return (bench_cycles() - t0) / REPS;
+}
+
+static uint32_t time_memset(uint8_t *d, int n) {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) {
+    memset(d, r, n);
+    bench_sink(d);
+  }
+  return (bench_cycles() - t0) / REPS;
+}
+
+int main() {
+  fill(src_buf, sizeof(src_buf), 3);
+
+  printf("memcpy cycles per call (cycles per 100 bytes)\n");
+  printf("%6s %3s %3s %8s %8s\n", "size", "src", "dst", "cycles", "c/100B");
+  for (int i = 0; i < LENGTH(sizes); i++) {
+    int n = sizes[i];
+    for (int so = 0; so < 4; so++) {
+      for (int dof = 0; dof < 4; dof++) {
+        uint32_t c = time_memcpy(dst_buf + dof, src_buf + so, n);
+        verify_copy(dst_buf + dof, src_buf + so, n);
+        printf("%6d %3d %3d %8d %8d\n", n, so, dof, c, c * 100 / n);
+      }
+    }
+  }
+
+  printf("memmove (overlapping, dst = src +/- 1) cycles per call\n");
+  printf("%6s %8s %8s\n", "size", "forward", "backward");
+  for (int i = 0; i < LENGTH(sizes) - 1; i++) {
+    int n = sizes[i];
+    uint32_t fwd = time_memmove(dst_buf, dst_buf + 1, n);
+    uint32_t bwd = time_memmove(dst_buf + 1, dst_buf, n);
+    printf("%6d %8d %8d\n", n, fwd, bwd);
+  }
+  fill(dst_buf, 16, 0);
+  memmove(dst_buf + 3, dst_buf, 13);
+  for (int i = 0; i < 13; i++) check(dst_buf[i + 3] == (uint8_t)(i * 7));
+  memmove(dst_buf, dst_buf + 3, 13);
+  for (int i = 0; i < 13; i++) check(dst_buf[i] == (uint8_t)(i * 7));
+
+  printf("memset cycles per call\n");
+  printf("%6s %3s %8s %8s\n", "size", "dst", "cycles", "c/100B");
+  for (int i = 0; i < LENGTH(sizes); i++) {
+    int n = sizes[i];
+    for (int dof = 0; dof < 4; dof++) {
+      uint32_t c = time_memset(dst_buf + dof, n);
+      for (int k = 0; k < n; k++) check(dst_buf[dof + k] == REPS - 1);
+      printf("%6d %3d %8d %8d\n", n, dof, c, c * 100 / n);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include "bench.h"
+
+// cost of reading the counters, and cycles/IPC of a dependent vs an
+// independent add chain as a sanity check of read_cycle64/read_instret64
+
+#define REPS  16
+#define CHAIN 1024
+
+__attribute__((noinline))
+static uint32_t dep_chain(uint32_t x) {
+  for (int i = 0; i < CHAIN; i++) {
+    x += i;
+    x ^= x >> 3;
+    x += 7;
+    x ^= x << 1;
+  }
+  return x;
+}
+
+__attribute__((noinline))
+static uint32_t indep_chain(uint32_t x) {
+  uint32_t a = x, b = x + 1, c = x + 2, d = x + 3;
+  for (int i = 0; i < CHAIN; i++) {
+    a += i;
+    b ^= i;
+    c += 7;
+    d ^= 5;
+  }
+  return a ^ b ^ c ^ d;
+}
+
+int main() {
+  // the counters must move forward and the 64-bit read must agree with the
+  // low word read right before it
+  uint32_t lo = read_cycle();
+  uint64_t c64 = read_cycle64();
+  check((uint32_t)c64 - lo < 1000);
+  check(read_instret64() > 0);
+  perf_snapshot s0 = perf_read(), s1 = perf_read();
+  check(s1.cycles > s0.cycles && s1.instret > s0.instret);
+
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(read_cycle());
+  printf("read_cycle:    %d cycles\n", (bench_cycles() - t0) / REPS);
+  t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(read_cycle64());
+  printf("read_cycle64:  %d cycles\n", (bench_cycles() - t0) / REPS);
+  t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(perf_read().instret);
+  printf("perf_read:     %d cycles\n", (bench_cycles() - t0) / REPS);
+
+  perf_snapshot b = perf_read();
+  bench_sink(dep_chain(1));
+  bench_report("dependent chain  ", perf_delta(b, perf_read()));
+  b = perf_read();
+  bench_sink(indep_chain(1));
+  bench_report("independent chain", perf_delta(b, perf_read()));
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "bench.h"
+
+// cycles per snprintf conversion, checked against known strings
+
+#define REPS 16
+
+static char buf[64];
+
+#define TIME_FMT(fmt, val) ({ \
+    uint32_t __t0 = bench_cycles(); \
+    for (int __r = 0; __r < REPS; __r++) { \
+      snprintf(buf, sizeof(buf), fmt, val); \
+      bench_sink(buf); \
+    } \
+    (bench_cycles() - __t0) / REPS; })
+
+static const uint32_t vals[] = {7, 12345, 2147483647u, 4294967295u};
+static const uint64_t vals64[] = {12345, 0x123456789ull, 1000000000000000000ull, 0xffffffffffffffffull};
+
+int main() {
+  snprintf(buf, sizeof(buf), "%u", 4294967295u);
+  check(strcmp(buf, "4294967295") == 0);
+  snprintf(buf, sizeof(buf), "%d|%x|%o", -1234567, 0xdeadbeef, 0755);
+  check(strcmp(buf, "-1234567|deadbeef|755") == 0);
+  snprintf(buf, sizeof(buf), "%08X|%-6d|%5u", 0xbeef, 42, 7);
+  check(strcmp(buf, "0000BEEF|42    |    7") == 0);
+  snprintf(buf, sizeof(buf), "%llu", 0xffffffffffffffffull);
+  check(strcmp(buf, "18446744073709551615") == 0);
+  snprintf(buf, sizeof(buf), "%lld|%llx", -9000000000ll, 0x123456789abcdefull);
+  check(strcmp(buf, "-9000000000|123456789abcdef") == 0);
+  snprintf(buf, sizeof(buf), "%zd|%zu|%ld", (ptrdiff_t)-5, (size_t)5, -7l);
+  check(strcmp(buf, "-5|5|-7") == 0);
+  snprintf(buf, sizeof(buf), "%.3f|%8.2f|%e", 0.5965, -12.125, 1234.5);
+  check(strcmp(buf, "0.597|  -12.12|1.234500e+03") == 0);
+  // just below a halfway point once scaled, which the 17-digit expansion loses
+  snprintf(buf, sizeof(buf), "%.3e|%.4e", 6.6235e-13, 9.27235e-254);
+  check(strcmp(buf, "6.623e-13|9.2723e-254") == 0);
+
+  printf("snprintf cycles per conversion\n");
+  printf("%12s %6s %6s %6s\n", "value", "%u", "%x", "%o");
+  for (int i = 0; i < LENGTH(vals); i++) {
+    uint32_t v = vals[i];
+    uint32_t t_dec = TIME_FMT("%u", v);
+    uint32_t t_hex = TIME_FMT("%x", v);
+    uint32_t t_oct = TIME_FMT("%o", v);
+    printf("%12u %6d %6d %6d\n", v, t_dec, t_hex, t_oct);
+  }
+  printf("%20s %6s %6s %6s\n", "value", "%llu", "%llx", "%llo");
+  for (int i = 0; i < LENGTH(vals64); i++) {
+    uint64_t v = vals64[i];
+    uint32_t t_dec = TIME_FMT("%llu", v);
+    uint32_t t_hex = TIME_FMT("%llx", v);
+    uint32_t t_oct = TIME_FMT("%llo", v);
+    printf("%20llu %6d %6d %6d\n", v, t_dec, t_hex, t_oct);
+  }
+  printf("%20s %6s %6s\n", "value", "%.3f", "%.6e");
+  static const double fvals[] = {0.5965, 3.14159265, 1234567.875};
+  for (int i = 0; i < LENGTH(fvals); i++) {
+    double v = fvals[i];
+    uint32_t t_f = TIME_FMT("%.3f", v);
+    uint32_t t_e = TIME_FMT("%.6e", v);
+    printf("%20.6f %6d %6d\n", v, t_f, t_e);
+  }
+
+  // print_ratio is the soft-float-free way to report IPC and friends
+  uint32_t t0 = bench_cycles();
+  print_ratio(82046, 137545, 4);
+  uint32_t t_ratio = bench_cycles() - t0;
+  printf(" <- print_ratio(82046, 137545, 4): %d cycles\n", t_ratio);
+  return 0;
+}
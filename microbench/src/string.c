@@ -0,0 +1,76 @@
+#include "bench.h"
+
+// cycles of the str* family over string lengths, checked against byte loops
+
+#define MAX_LEN 1024
+#define REPS    8
+
+#ifdef __riscv_zbb
+#define VARIANT "zbb orc.b"
+#else
+#define VARIANT "swar"
+#endif
+
+static const int lens[] = {1, 7, 30, 100, MAX_LEN};
+
+static char s1[MAX_LEN + 8] __attribute__((aligned(8)));
+static char s2[MAX_LEN + 8] __attribute__((aligned(8)));
+
+static size_t ref_strlen(const char *s) {
+  size_t n = 0;
+  while (s[n]) n++;
+  return n;
+}
+
+static void make(char *s, int len) {
+  for (int i = 0; i < len; i++) s[i] = 'A' + i % 26;
+  s[len] = '\0';
+}
+
+#define TIME(expr) ({ \
+    uint32_t __t0 = bench_cycles(); \
+    for (int __r = 0; __r < REPS; __r++) { bench_sink(expr); } \
+    (bench_cycles() - __t0) / REPS; })
+
+int main() {
+  printf("str* cycles per call (%s)\n", VARIANT);
+  printf("%5s %7s %7s %7s %7s %7s\n", "len", "strlen", "strcmp", "strncmp", "strchr", "strrchr");
+  for (int i = 0; i < LENGTH(lens); i++) {
+    int len = lens[i];
+    make(s1, len);
+    make(s2, len);
+    check(strlen(s1) == ref_strlen(s1));
+    check(strcmp(s1, s2) == 0);
+    check(strncmp(s1, s2, len + 1) == 0);
+    check(strchr(s1, '\n') == NULL);
+    check(strrchr(s1, s1[0]) == s1 + (len - 1) / 26 * 26);
+
+    uint32_t t_len   = TIME(strlen(s1));
+    uint32_t t_cmp   = TIME(strcmp(s1, s2));
+    uint32_t t_ncmp  = TIME(strncmp(s1, s2, len));
+    uint32_t t_chr   = TIME(strchr(s1, '\n'));
+    uint32_t t_rchr  = TIME(strrchr(s1, 'A'));
+    printf("%5d %7d %7d %7d %7d %7d\n", len, t_len, t_cmp, t_ncmp, t_chr, t_rchr);
+  }
+
+  // the Dhrystone inner loop: strcpy of a 30-char literal plus one strcmp
+  static char str_1[31], str_2[31];
+  strcpy(str_1, "DHRYSTONE PROGRAM, 1'ST STRING");
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) {
+    strcpy(str_2, "DHRYSTONE PROGRAM, 2'ND STRING");
+    bench_sink(strcmp(str_1, str_2));
+  }
+  printf("dhrystone strcpy+strcmp: %d cycles\n", (bench_cycles() - t0) / REPS);
+  check(strcmp(str_1, str_2) < 0);
+
+  // unaligned starting points fall back to byte heads and tails
+  make(s1, 64);
+  make(s2, 64);
+  for (int off = 1; off < 4; off++) {
+    check(strlen(s1 + off) == 64 - off);
+    check(strcmp(s1 + off, s2 + off) == 0);
+    check(strcmp(s1 + off, s2 + off + 1) < 0);
+  }
+  return 0;
+}
@@ -0,0 +1,65 @@
+#include "bench.h"
+
+// load latency and streaming sum over DTCM vs RAM, and a call into ITCM vs
+// RAM code (build with DTCM_BASE=/ITCM_BASE= to place them in the TCMs)
+
+#define N    1024
+#define REPS 4
+
+static uint32_t ram_buf[N];
+static uint32_t tcm_buf[N] __dtcm_bss;
+
+static void make_chain(uint32_t *p) {
+  // stride through the buffer so every load depends on the previous one
+  for (int i = 0; i < N; i++) p[i] = (uint32_t)&p[(i + 97) % N];
+}
+
+static uint32_t chase(uint32_t *p) {
+  uint32_t t0 = bench_cycles();
+  uint32_t *q = p;
+  for (int i = 0; i < N * REPS; i++) q = (uint32_t *)*q;
+  bench_sink(q);
+  return bench_cycles() - t0;
+}
+
+static uint32_t sum(uint32_t *p) {
+  uint32_t t0 = bench_cycles(), s = 0;
+  for (int r = 0; r < REPS; r++)
+    for (int i = 0; i < N; i++) s += p[i];
+  bench_sink(s);
+  return bench_cycles() - t0;
+}
+
+__attribute__((noinline)) static int ram_fn(int x) { return x * 3 + 1; }
+static int __itcm tcm_fn(int x) { return x * 3 + 1; }
+
+static uint32_t calls(int (*fn)(int)) {
+  uint32_t t0 = bench_cycles();
+  int x = 0;
+  for (int i = 0; i < N; i++) x = fn(x);
+  bench_sink(x);
+  return bench_cycles() - t0;
+}
+
+int main() {
+  make_chain(ram_buf);
+  make_chain(tcm_buf);
+  check(tcm_fn(5) == ram_fn(5));
+
+  printf("dtcm at %p, itcm fn at %p\n", (void *)tcm_buf, (void *)tcm_fn);
+  printf("%-16s %8s %8s\n", "cycles/element", "ram", "tcm");
+  printf("%-16s ", "dependent load");
+  print_ratio(chase(ram_buf), N * REPS, 2);
+  putch(' ');
+  print_ratio(chase(tcm_buf), N * REPS, 2);
+  printf("\n%-16s ", "streaming sum");
+  print_ratio(sum(ram_buf), N * REPS, 2);
+  putch(' ');
+  print_ratio(sum(tcm_buf), N * REPS, 2);
+  printf("\n%-16s ", "call");
+  print_ratio(calls(ram_fn), N, 2);
+  putch(' ');
+  print_ratio(calls(tcm_fn), N, 2);
+  putch('\n');
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include "bench.h"
+
+// trap latency through cte: ecall -> handler entry, handler -> back after
+// ecall, and the full yield round trip, plus a syscall returning a value
+
+#define REPS 16
+
+static volatile uint32_t t_handler;
+static int nr_yield, nr_syscall;
+
+static Context *handler(Event ev, Context *c) {
+  t_handler = read_cycle();
+  switch (ev.event) {
+    case EVENT_YIELD:   nr_yield++; break;
+    case EVENT_SYSCALL: nr_syscall++; c->SYS_RET = c->SYS_ARG1 + c->SYS_ARG2; break;
+    default: halt(1);
+  }
+  return c;
+}
+
+static uintptr_t syscall(uintptr_t nr, uintptr_t a, uintptr_t b) {
+  register uintptr_t a7 asm("a7") = nr;
+  register uintptr_t a0 asm("a0") = a;
+  register uintptr_t a1 asm("a1") = b;
+  asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a7) : "memory");
+  return a0;
+}
+
+int main() {
+  cte_init(handler);
+
+  // caller-saved registers the handler may clobber must survive the trap
+  register uint32_t t3 asm("t3") = 0x12345678;
+  asm volatile("li a7, -1; ecall" : "+r"(t3) : : "a7", "memory");
+  check(nr_yield == 1);
+  check(t3 == 0x12345678);
+  check(syscall(1, 40, 2) == 42);
+  check(nr_syscall == 1);
+
+  uint32_t entry = 0, exit = 0;
+  for (int r = 0; r < REPS; r++) {
+    uint32_t t0 = read_cycle();
+    yield();
+    uint32_t t1 = read_cycle();
+    entry += t_handler - t0;
+    exit  += t1 - t_handler;
+  }
+  printf("trap entry -> handler:  %d cycles\n", entry / REPS);
+  printf("handler -> mret return: %d cycles\n", exit / REPS);
+
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) yield();
+  printf("yield round trip:       %d cycles\n", (bench_cycles() - t0) / REPS);
+
+  t0 = bench_cycles();
+  for (int r = 0; r < REPS; r++) bench_sink(syscall(1, r, r));
+  printf("syscall round trip:     %d cycles\n", (bench_cycles() - t0) / REPS);
+
+  check(nr_yield == 1 + 2 * REPS);
+  return 0;
+}
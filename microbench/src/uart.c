@@ -0,0 +1,35 @@
+#include "bench.h"
+#include <dev-mmio.h>
+
+// console cost per character: one uncached store per character (the old
+// putch) against the buffered putch, which batches stores at each newline
+
+#define LINES 16
+
+static const char line[] = "the quick brown fox jumps over the lazy dog 0123456789\n";
+#define LINE_LEN (sizeof(line) - 1)
+
+static uint32_t direct() {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < LINES; r++)
+    for (const char *p = line; *p; p++) outb(SERIAL_PORT, *p);
+  return bench_cycles() - t0;
+}
+
+static uint32_t buffered() {
+  uint32_t t0 = bench_cycles();
+  for (int r = 0; r < LINES; r++) putstr(line);
+  return bench_cycles() - t0;
+}
+
+int main() {
+  flush();
+  uint32_t d = direct();
+  uint32_t b = buffered();
+  printf("direct outb:     ");
+  print_ratio(d, LINES * LINE_LEN, 2);
+  printf(" cycles/char\nbuffered putch:  ");
+  print_ratio(b, LINES * LINE_LEN, 2);
+  printf(" cycles/char\n");
+  return 0;
+}
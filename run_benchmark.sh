@@ -15,6 +15,10 @@ mkdir -p "$dir"
 
 total_cycles_sum=0
 total_ipc_sum=0
+roi_cycles_sum=0
+roi_instrs_sum=0
+roi_ipc_sum=0
+roi_runs=0
 
 for ((i=1;i<=runs;i++))
 do
@@ -41,6 +45,22 @@ do
     # 累加
     total_cycles_sum=$(echo "$total_cycles_sum + $cycles" | bc)
     total_ipc_sum=$(echo "$total_ipc_sum + $ipc" | bc -l)
+
+    # ROI_BEGIN()/ROI_END() 区间的统计 (不含启动和结果校验), 程序未插桩时没有这一行
+    roi=$(echo "$output" | grep "ROI cycles:" | tail -n 1 | sed 's/\x1b\[[0-9;]*m//g')
+    if [ -n "$roi" ]; then
+        echo "$roi"
+        echo "$roi" >> "$logfile"
+        startup=$(echo "$output" | grep "Startup cycles:" | tail -n 1 | sed 's/\x1b\[[0-9;]*m//g')
+        [ -n "$startup" ] && echo "$startup" && echo "$startup" >> "$logfile"
+        roi_cycles=$(echo "$roi" | awk '{print $3}' | tr -cd '0-9')
+        roi_instrs=$(echo "$roi" | awk '{print $5}' | tr -cd '0-9')
+        roi_ipc=$(echo "$roi" | awk '{print $7}' | tr -cd '0-9.')
+        roi_cycles_sum=$(echo "$roi_cycles_sum + $roi_cycles" | bc)
+        roi_instrs_sum=$(echo "$roi_instrs_sum + $roi_instrs" | bc)
+        roi_ipc_sum=$(echo "$roi_ipc_sum + ${roi_ipc:-0}" | bc -l)
+        roi_runs=$((roi_runs + 1))
+    fi
 done
 
 # 计算平均值
@@ -49,7 +69,19 @@ avg_ipc=$(echo "scale=5; $total_ipc_sum / $runs" | bc)
 
 echo "✅ 平均 Total cycles: $avg_cycles"
 echo "✅ 平均 IPC: $avg_ipc"
-echo "结果已保存到: $logfile"
-
 echo "✅ 平均 Total cycles: $avg_cycles" >> "$logfile"
 echo "✅ 平均 IPC: $avg_ipc" >> "$logfile"
+
+if [ "$roi_runs" -gt 0 ]; then
+    avg_roi_cycles=$(echo "scale=2; $roi_cycles_sum / $roi_runs" | bc)
+    avg_roi_instrs=$(echo "scale=2; $roi_instrs_sum / $roi_runs" | bc)
+    avg_roi_ipc=$(echo "scale=5; $roi_ipc_sum / $roi_runs" | bc)
+    echo "✅ 平均 ROI cycles: $avg_roi_cycles"
+    echo "✅ 平均 ROI instrs: $avg_roi_instrs"
+    echo "✅ 平均 ROI IPC: $avg_roi_ipc"
+    echo "✅ 平均 ROI cycles: $avg_roi_cycles" >> "$logfile"
+    echo "✅ 平均 ROI instrs: $avg_roi_instrs" >> "$logfile"
+    echo "✅ 平均 ROI IPC: $avg_roi_ipc" >> "$logfile"
+fi
+
+echo "结果已保存到: $logfile"
@@ -65,7 +65,7 @@ int ans[] = {0, 0x1, 0x2, 0x7fffffff, 0x80000000, 0x80000001, 0xfffffffe, 0xffff
 #define NR_DATA LENGTH(test_data)
 
 int main() {
-	static int b[512] = {
+	static int b[512] __dtcm = {
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0,
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,
@@ -82,7 +82,7 @@ int main() {
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,
         1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,0  ,1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,}; //初始化在DATA段中
-        static int a[512] = {
+        static int a[512] __dtcm = {
             0,1,2,3, 4,5,6,7, 8,9,10,11, 12,13,14,15,
             16,17,18,19, 20,21,22,23, 24,25,26,27, 28,29,30,31,
             32,33,34,35, 36,37,38,39, 40,41,42,43, 44,45,46,47,
@@ -116,8 +116,9 @@ int main() {
             480,481,482,483, 484,485,486,487, 488,489,490,491, 492,493,494,495,
             496,497,498,499, 500,501,502,503, 504,505,506,507, 508,509,510,511
         };
-        int c[512] ;
+        static int c[512] __dtcm_bss;
     int test = 1;
+	ROI_BEGIN();
 	cfg_i(test,512,0); //
 	cfg_i(test,512,1); //
 	cfg_load((uint32_t)a,0);
@@ -135,6 +136,7 @@ int main() {
             //step_i(0);
         }
     }
+	ROI_END();
 
 
 	return 0;